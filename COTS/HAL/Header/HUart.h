@@ -26,6 +26,17 @@
 #define HUART_FLOW_CONTROL_DIS 0x00000000
 
 typedef void (*hUartAppNotify_t)(void);
+typedef void (*hUartErrorNotify_t)(uint8_t*, uint16_t);
+
+/**
+ * @brief A segment of a scatter gather transmission
+ * 
+ */
+typedef struct
+{
+    uint8_t* data;      /* The bytes of the segment */
+    uint16_t len;       /* The length of the segment in bytes (not 0) */
+}hUartIov_t;
 
 /**
  * @brief Initializes the UART Module
@@ -66,6 +77,17 @@ extern Std_ReturnType HUart_Config(uint32_t baudRate, uint32_t stopBits, uint32_
  *                  E_NOT_OK: If the did not execute successfully
  */
 extern Std_ReturnType HUart_SetModule(uint8_t uartModule);
+/**
+ * @brief Sets the notification of the packets the UART driver refused on the current module,
+ * such a packet is dropped without its application notification so this is the only report of it
+ *
+ * @param notify The error notification, it gets the bytes and the length that were refused
+ *               (the refused segment of a scatter gather packet), NULL for none
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType HUart_SetErrorCb(hUartErrorNotify_t notify);
 /**
  * @brief Sends data through the UART
  *
@@ -77,6 +99,20 @@ extern Std_ReturnType HUart_SetModule(uint8_t uartModule);
  *                  E_NOT_OK: If the driver can't send data right now
  */
 extern Std_ReturnType HUart_Send(uint8_t *data, uint16_t length, hUartAppNotify_t notify);
+/**
+ * @brief Sends discontiguous segments through the UART as one transmission,
+ * every segment is started from the transmission complete of the one before it
+ * and the notification is called after the last one
+ * *The segments and their bytes must stay valid until the notification
+ *
+ * @param iov The segments in the order they are sent
+ * @param count The number of the segments
+ * @param notify The application notification
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now or a segment is empty
+ */
+extern Std_ReturnType HUart_SendV(const hUartIov_t* iov, uint8_t count, hUartAppNotify_t notify);
 /**
  * @brief Receives data through the UART
  *
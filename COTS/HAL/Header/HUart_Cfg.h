@@ -22,4 +22,7 @@
 
 #define HUART_USE_DMA
 
+/* The group priority of the UART and DMA interrupts, it must be masked by CRITICAL_PRIORITY_LEVEL */
+#define HUART_IRQ_GROUP_PRIORITY     1
+
 #endif
\ No newline at end of file
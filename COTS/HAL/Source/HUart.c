@@ -9,10 +9,14 @@
  * 
  */
 #include "Std_Types.h"
+#include "Critical_Cfg.h"
+#include "Critical.h"
 #include "Queue.h"
+#include "Ring.h"
 #include "Uart.h"
 #include "Uart_Cfg.h"
 #include "HUart.h"
+#include "Nvic_Cfg.h"
 #include "Nvic.h"
 #include "Rcc.h"
 #include "Gpio.h"
@@ -24,6 +28,11 @@
 
 #define UART_QUEUE_LENGTH             5
 
+/* The interrupts that use the queues must be masked by the critical sections */
+#if (HUART_IRQ_GROUP_PRIORITY << NVIC_SUBGROUP_SIZE) < CRITICAL_PRIORITY_LEVEL
+#error "HUART_IRQ_GROUP_PRIORITY must be at or below CRITICAL_PRIORITY_LEVEL"
+#endif
+
 #define UART_NUMBER_OF_MODULES        3
 
 #define HUART_NOT_INITIALIZED         1
@@ -37,23 +46,63 @@
  */
 typedef struct
 {
-    uint8_t* data;
+    uint8_t* data;              /* The bytes being sent (the current segment of a scatter gather packet) */
     uint16_t len;
     hUartAppNotify_t appNotify;
+    const hUartIov_t* iov;      /* The segments of a scatter gather packet, NULL for a single buffer */
+    uint8_t count;              /* The number of the segments */
+    uint8_t index;              /* The segment being sent */
 }hUartPacket_t;
 
 
 static volatile queue_t HUart_rxQueue[UART_NUMBER_OF_MODULES];
 static volatile queue_t HUart_txQueue[UART_NUMBER_OF_MODULES];
 
+/* The queues live in exactly sized storage so a new init reuses it instead of allocating again */
+static uint32_t HUart_rxQueueStorage[UART_NUMBER_OF_MODULES][QUEUE_STORAGE_WORDS(sizeof(hUartPacket_t), UART_QUEUE_LENGTH)];
+static uint32_t HUart_txQueueStorage[UART_NUMBER_OF_MODULES][QUEUE_STORAGE_WORDS(sizeof(hUartPacket_t), UART_QUEUE_LENGTH)];
+
 static volatile uint8_t HUart_module =  HUART_DEFAULT_MODULE;
 static volatile uint8_t isInitialized[UART_NUMBER_OF_MODULES] = {HUART_NOT_INITIALIZED, HUART_NOT_INITIALIZED, HUART_NOT_INITIALIZED};
 static volatile uint8_t isConfigured[UART_NUMBER_OF_MODULES] =  {HUART_NOT_CONFIGURED, HUART_NOT_CONFIGURED, HUART_NOT_CONFIGURED};
+static volatile hUartErrorNotify_t HUart_errorNotify[UART_NUMBER_OF_MODULES];
 
 
 static void HUart_TxCallBack(uint8_t module);
 static void HUart_RxCallBack(uint8_t module);
 
+/**
+ * @brief Starts the packet at the front of the TX queue, a packet the driver refuses
+ * is reported to the error notification and dropped so the ones after it still go out
+ * 
+ * @param module The number of the UART module
+ *                  @arg HUART_MODULE_1
+ *                  @arg HUART_MODULE_2
+ *                  @arg HUART_MODULE_3
+ * @return Std_ReturnType A Status
+ *                  E_OK: If a packet was started
+ *                  E_NOT_OK: If the queue is empty or every packet was refused
+ */
+static Std_ReturnType HUart_StartTx(uint8_t module)
+{
+    Std_ReturnType error = E_NOT_OK;
+    hUartPacket_t* packet;
+    while(E_NOT_OK == error && E_OK == Queue_PeekFront(&(HUart_txQueue[module]), (uint8_t**)(&packet)))
+    {
+        error = Uart_Send(packet->data, packet->len, module);
+        if(E_NOT_OK == error)
+        {
+            /* No transfer runs for it so its application notification would never come */
+            if(HUart_errorNotify[module])
+            {
+                HUart_errorNotify[module](packet->data, packet->len);
+            }
+            Queue_ReleaseFront(&(HUart_txQueue[module]));
+        }
+    }
+    return error;
+}
+
 
 /**
  * @brief Initializes the UART Module
@@ -64,8 +113,10 @@ static void HUart_RxCallBack(uint8_t module);
 Std_ReturnType HUart_Init(void)
 {
     gpio_t gpio;
-    Queue_CreateQueue(&(HUart_rxQueue[HUart_module]), sizeof(hUartPacket_t), UART_QUEUE_LENGTH);
-    Queue_CreateQueue(&(HUart_txQueue[HUart_module]), sizeof(hUartPacket_t), UART_QUEUE_LENGTH);
+    Queue_CreateStatic(&(HUart_rxQueue[HUart_module]), HUart_rxQueueStorage[HUart_module],
+                       sizeof(HUart_rxQueueStorage[HUart_module]), sizeof(hUartPacket_t), UART_QUEUE_LENGTH);
+    Queue_CreateStatic(&(HUart_txQueue[HUart_module]), HUart_txQueueStorage[HUart_module],
+                       sizeof(HUart_txQueueStorage[HUart_module]), sizeof(hUartPacket_t), UART_QUEUE_LENGTH);
 #ifdef UART_USE_DMA
     Rcc_SetAhbPeriphClockState(RCC_DMA1_CLK_EN, RCC_PERIPH_CLK_ON);
 #endif
@@ -85,8 +136,10 @@ Std_ReturnType HUart_Init(void)
             Uart_SetTxCb(HUart_TxCallBack, UART1);
             Uart_SetRxCb(HUart_RxCallBack, UART1);
             Rcc_SetApb2PeriphClockState(RCC_USART1_CLK_EN, RCC_PERIPH_CLK_ON);
+            Nvic_SetGroupPriority(HUART_IRQ_GROUP_PRIORITY, NVIC_IRQNUM_USART1);
             Nvic_EnableInterrupt(NVIC_IRQNUM_USART1);
 #ifdef UART_USE_DMA
+            Nvic_SetGroupPriority(HUART_IRQ_GROUP_PRIORITY, NVIC_IRQNUM_DMA1_CHANNEL5);
             Nvic_EnableInterrupt(NVIC_IRQNUM_DMA1_CHANNEL5);
 #endif
             break;
@@ -103,8 +156,10 @@ Std_ReturnType HUart_Init(void)
             Uart_SetTxCb(HUart_TxCallBack, UART2);
             Uart_SetRxCb(HUart_RxCallBack, UART2);
             Rcc_SetApb1PeriphClockState(RCC_USART2_CLK_EN, RCC_PERIPH_CLK_ON);
+            Nvic_SetGroupPriority(HUART_IRQ_GROUP_PRIORITY, NVIC_IRQNUM_USART2);
             Nvic_EnableInterrupt(NVIC_IRQNUM_USART2);
 #ifdef UART_USE_DMA
+            Nvic_SetGroupPriority(HUART_IRQ_GROUP_PRIORITY, NVIC_IRQNUM_DMA1_CHANNEL6);
             Nvic_EnableInterrupt(NVIC_IRQNUM_DMA1_CHANNEL6);
 #endif
             break;
@@ -121,8 +176,10 @@ Std_ReturnType HUart_Init(void)
             Uart_SetTxCb(HUart_TxCallBack, UART3);
             Uart_SetRxCb(HUart_RxCallBack, UART3);
             Rcc_SetApb1PeriphClockState(RCC_USART3_CLK_EN, RCC_PERIPH_CLK_ON);
+            Nvic_SetGroupPriority(HUART_IRQ_GROUP_PRIORITY, NVIC_IRQNUM_USART3);
             Nvic_EnableInterrupt(NVIC_IRQNUM_USART3);
 #ifdef UART_USE_DMA
+            Nvic_SetGroupPriority(HUART_IRQ_GROUP_PRIORITY, NVIC_IRQNUM_DMA1_CHANNEL3);
             Nvic_EnableInterrupt(NVIC_IRQNUM_DMA1_CHANNEL3);
 #endif            
             break;
@@ -178,6 +235,21 @@ Std_ReturnType HUart_SetModule(uint8_t uartModule)
     HUart_module = uartModule;
     return E_OK;
 }
+/**
+ * @brief Sets the notification of the packets the UART driver refused on the current module,
+ * such a packet is dropped without its application notification so this is the only report of it
+ *
+ * @param notify The error notification, it gets the bytes and the length that were refused
+ *               (the refused segment of a scatter gather packet), NULL for none
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType HUart_SetErrorCb(hUartErrorNotify_t notify)
+{
+    HUart_errorNotify[HUart_module] = notify;
+    return E_OK;
+}
 /**
  * @brief Sends data through the UART
  *
@@ -191,15 +263,90 @@ Std_ReturnType HUart_SetModule(uint8_t uartModule)
 Std_ReturnType HUart_Send(uint8_t *data, uint16_t length, hUartAppNotify_t notify)
 {
     Std_ReturnType error = E_NOT_OK;
-    hUartPacket_t pack;
-    /* If the current Uart module is initialized */
-    if(HUART_INITIALIZED == isInitialized[HUart_module])
+    hUartPacket_t* pack;
+    uint32_t state;
+    uint16_t pending;
+    /* If the current Uart module is initialized and the data is valid */
+    if(HUART_INITIALIZED == isInitialized[HUart_module] && data && length > 0)
     {
-        pack.data = data;
-        pack.len = length;
-        pack.appNotify = notify;
-        error = Queue_Enqueue(&(HUart_txQueue[HUart_module]), (uint8_t*)(&pack));
-        Uart_Send(pack.data, pack.len, HUart_module);
+        /* Fill the packet in its queue slot */
+        error = Queue_ReserveBack(&(HUart_txQueue[HUart_module]), (uint8_t**)(&pack));
+        if(E_OK == error)
+        {
+            pack->data = data;
+            pack->len = length;
+            pack->appNotify = notify;
+            pack->iov = NULL;
+            /* The callback can not pop a packet between the check and the commit */
+            state = Critical_Enter();
+            Queue_GetSize(&(HUart_txQueue[HUart_module]), &pending);
+            Queue_CommitBack(&(HUart_txQueue[HUart_module]));
+            Critical_Exit(state);
+            /* Only the first packet is started here, the callback starts the ones after it */
+            if(0 == pending)
+            {
+                error = HUart_StartTx(HUart_module);
+            }
+        }
+    }
+    return error;
+}
+/**
+ * @brief Sends discontiguous segments through the UART as one transmission,
+ * every segment is started from the transmission complete of the one before it
+ * and the notification is called after the last one
+ * *The segments and their bytes must stay valid until the notification
+ *
+ * @param iov The segments in the order they are sent
+ * @param count The number of the segments
+ * @param notify The application notification
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the driver is ready to send
+ *                  E_NOT_OK: If the driver can't send data right now or a segment is empty
+ */
+Std_ReturnType HUart_SendV(const hUartIov_t* iov, uint8_t count, hUartAppNotify_t notify)
+{
+    Std_ReturnType error = E_NOT_OK;
+    hUartPacket_t* pack;
+    uint32_t state;
+    uint16_t pending;
+    uint8_t itr;
+    /* If the current Uart module is initialized and the segments are valid */
+    if(HUART_INITIALIZED == isInitialized[HUart_module] && iov && count > 0)
+    {
+        error = E_OK;
+        /* An empty segment would never complete so the chain would stop on it */
+        for(itr=0; itr<count; itr++)
+        {
+            if(NULL == iov[itr].data || 0 == iov[itr].len)
+            {
+                error = E_NOT_OK;
+            }
+        }
+        if(E_OK == error)
+        {
+            /* Fill the packet in its queue slot */
+            error = Queue_ReserveBack(&(HUart_txQueue[HUart_module]), (uint8_t**)(&pack));
+        }
+        if(E_OK == error)
+        {
+            pack->data = iov[0].data;
+            pack->len = iov[0].len;
+            pack->appNotify = notify;
+            pack->iov = iov;
+            pack->count = count;
+            pack->index = 0;
+            /* The callback can not pop a packet between the check and the commit */
+            state = Critical_Enter();
+            Queue_GetSize(&(HUart_txQueue[HUart_module]), &pending);
+            Queue_CommitBack(&(HUart_txQueue[HUart_module]));
+            Critical_Exit(state);
+            /* Only the first packet is started here, the callback starts the ones after it */
+            if(0 == pending)
+            {
+                error = HUart_StartTx(HUart_module);
+            }
+        }
     }
     return error;
 }
@@ -216,15 +363,30 @@ Std_ReturnType HUart_Send(uint8_t *data, uint16_t length, hUartAppNotify_t notif
 Std_ReturnType HUart_Receive(uint8_t *data, uint16_t length, hUartAppNotify_t notify)
 {
     Std_ReturnType error = E_NOT_OK;
-    hUartPacket_t pack;
+    hUartPacket_t* pack;
+    uint32_t state;
+    uint16_t pending;
     /* If the current Uart module is initialized */
     if(HUART_INITIALIZED == isInitialized[HUart_module])
     {
-        pack.data = data;
-        pack.len = length;
-        pack.appNotify = notify;
-        error = Queue_Enqueue(&(HUart_rxQueue[HUart_module]), (uint8_t*)(&pack));
-        Uart_Receive(pack.data, pack.len, HUart_module);
+        /* Fill the packet in its queue slot */
+        error = Queue_ReserveBack(&(HUart_rxQueue[HUart_module]), (uint8_t**)(&pack));
+        if(E_OK == error)
+        {
+            pack->data = data;
+            pack->len = length;
+            pack->appNotify = notify;
+            /* The callback can not pop a packet between the check and the commit */
+            state = Critical_Enter();
+            Queue_GetSize(&(HUart_rxQueue[HUart_module]), &pending);
+            Queue_CommitBack(&(HUart_rxQueue[HUart_module]));
+            Critical_Exit(state);
+            /* Only the first packet is started here, the callback starts the ones after it */
+            if(0 == pending)
+            {
+                Uart_Receive(data, length, HUart_module);
+            }
+        }
     }
     return error;
 }
@@ -238,22 +400,29 @@ Std_ReturnType HUart_Receive(uint8_t *data, uint16_t length, hUartAppNotify_t no
  */
 static void HUart_TxCallBack(uint8_t module)
 {
-    hUartPacket_t packet;
+    hUartPacket_t* packet;
     /* If the first packet in the queue is valid */
-    if(E_OK == Queue_GetFront(&(HUart_txQueue[module]), (uint8_t*)(&packet)))
+    if(E_OK == Queue_PeekFront(&(HUart_txQueue[module]), (uint8_t**)(&packet)))
     {
-      if(packet.appNotify)
+      /* The next segment of a scatter gather packet goes on without the task */
+      if(packet->iov && packet->index + 1 < packet->count)
       {
-        packet.appNotify();
+        packet->index++;
+        packet->data = packet->iov[packet->index].data;
+        packet->len = packet->iov[packet->index].len;
+      }
+      else
+      {
+        if(packet->appNotify)
+        {
+          packet->appNotify();
+        }
+        /* Pop the packet from the queue */
+        Queue_ReleaseFront(&(HUart_txQueue[module]));
       }
-      /* Pop the packet from the queue */
-      Queue_Dequeue(&(HUart_txQueue[module]), (uint8_t*)(&packet));
-    }
-    /* If there were any other packets in the queue */
-    if(E_OK == Queue_GetFront(&(HUart_txQueue[module]), (uint8_t*)(&packet)))
-    {
-        Uart_Send(packet.data, packet.len, module);
     }
+    /* If there is a segment or any other packets in the queue */
+    HUart_StartTx(module);
 }
 /**
  * @brief The RX Callback function sent to the UART driver
@@ -265,20 +434,20 @@ static void HUart_TxCallBack(uint8_t module)
  */
 static void HUart_RxCallBack(uint8_t module)
 {
-    hUartPacket_t packet;
+    hUartPacket_t* packet;
     /* If the first packet in the queue is valid */
-    if(E_OK == Queue_GetFront(&(HUart_rxQueue[module]), (uint8_t*)(&packet)))
+    if(E_OK == Queue_PeekFront(&(HUart_rxQueue[module]), (uint8_t**)(&packet)))
     {
-      if(packet.appNotify)
+      if(packet->appNotify)
       {
-        packet.appNotify();
+        packet->appNotify();
       }
       /* Pop the packet from the queue */
-      Queue_Dequeue(&(HUart_rxQueue[module]), (uint8_t*)(&packet));
+      Queue_ReleaseFront(&(HUart_rxQueue[module]));
     }
     /* If there were any other packets in the queue */
-    if(E_OK == Queue_GetFront(&(HUart_rxQueue[module]), (uint8_t*)(&packet)))
+    if(E_OK == Queue_PeekFront(&(HUart_rxQueue[module]), (uint8_t**)(&packet)))
     {
-        Uart_Receive(packet.data, packet.len, module);
+        Uart_Receive(packet->data, packet->len, module);
     }
 }
@@ -11,6 +11,26 @@
 #ifndef ALLOC_H_
 #define ALLOC_H_
 
+/**
+ * @brief The accounting of an allocator or of one of its owners
+ * 
+ */
+typedef struct
+{
+    const char* name;       /* The name of the tag or the pool */
+    uint8_t id;             /* The tag id or the class id */
+    uint32_t inUse;         /* The bytes in use */
+    uint32_t peak;          /* The highest number of bytes that was in use */
+    uint32_t failures;      /* The number of failed allocations */
+    uint32_t headroom;      /* The bytes that can still be allocated */
+} allocReport_t;
+
+/**
+ * @brief The function that receives the reports of a dump
+ * 
+ */
+typedef void (*allocDumpCb_t)(const allocReport_t* report);
+
 /**
  * @brief This function allocates free bytes for the user
  * 
@@ -22,4 +42,52 @@
  */
 extern Std_ReturnType AllocBytes(void** ptr, uint16_t sizeInBytets);
 
-#endif
\ No newline at end of file
+/**
+ * @brief This function allocates free bytes and accounts them for an owner
+ * 
+ * @param ptr a place to return the address of the allocated bytes
+ * @param sizeInBytets the size of memory allocation in bytes
+ * @param tag the owner of the allocation
+ *          ALLOC_TAG_UNTAGGED
+ *          ALLOC_TAG_QUEUE
+ *          ALLOC_TAG_PRIO_QUEUE
+ *          ALLOC_TAG_ARENA
+ *          or an owner tag added in Alloc_Cfg.h
+ * @return Std_ReturnType a status
+ *          E_OK        If bytes allocated successfully
+ *          E_NOT_OK    If the function failed to allocate bytes 
+ */
+extern Std_ReturnType AllocTaggedBytes(void** ptr, uint16_t sizeInBytets, uint8_t tag);
+
+/**
+ * @brief Gets the accounting of all the allocations
+ * 
+ * @param report a place to return the accounting in
+ * @return Std_ReturnType a status
+ *          E_OK        If the accounting was returned successfully
+ *          E_NOT_OK    If the report is NULL
+ */
+extern Std_ReturnType Alloc_GetStats(allocReport_t* report);
+
+/**
+ * @brief Gets the accounting of the allocations of an owner
+ * 
+ * @param tag the owner of the allocations
+ * @param report a place to return the accounting in
+ * @return Std_ReturnType a status
+ *          E_OK        If the accounting was returned successfully
+ *          E_NOT_OK    If the tag is not configured or the report is NULL
+ */
+extern Std_ReturnType Alloc_GetTagStats(uint8_t tag, allocReport_t* report);
+
+/**
+ * @brief Passes the accounting of every owner then of all the allocations to a callback
+ * 
+ * @param dumpCb the function that receives the reports
+ * @return Std_ReturnType a status
+ *          E_OK        If the reports were passed successfully
+ *          E_NOT_OK    If the callback is NULL
+ */
+extern Std_ReturnType Alloc_Dump(allocDumpCb_t dumpCb);
+
+#endif
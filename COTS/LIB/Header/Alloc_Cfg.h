@@ -0,0 +1,26 @@
+/**
+ * @file Alloc_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This file contains the configurations for the Allocation tool
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef ALLOC_CFG_H_
+#define ALLOC_CFG_H_
+
+/* The memory shared by all the boot time allocations in bytes */
+#define MEM_MAX_SIZE                    8000
+
+/* The owners the allocations are accounted for, their names are configured in Alloc_Cfg.c,
+   the containers default to their own tag and the drivers add theirs after them for the *Tagged creators */
+#define ALLOC_TAG_UNTAGGED              0
+#define ALLOC_TAG_QUEUE                 1
+#define ALLOC_TAG_PRIO_QUEUE            2
+#define ALLOC_TAG_ARENA                 3
+
+#define ALLOC_NUMBER_OF_TAGS            4
+
+#endif
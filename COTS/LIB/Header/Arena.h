@@ -0,0 +1,112 @@
+/**
+ * @file Arena.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the Arena allocator, scratch memory for a transaction
+ *        that is taken by moving an offset and given back all at once by a mark
+ *        (an arena belongs to one context, it is not shared with the interrupts)
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef ARENA_H_
+#define ARENA_H_
+
+/**
+ * @brief The Arena
+ * 
+ */
+typedef struct
+{
+    uint8_t* buffer;        /* The storage, word aligned */
+    uint16_t size;          /* The size of the storage in bytes */
+    uint16_t used;          /* The bytes taken from the start of the storage */
+    uint16_t peak;          /* The most bytes that were taken at once */
+    uint16_t failures;      /* The number of failed allocations */
+} arena_t;
+
+/* A point of the Arena to give back the memory taken after it */
+typedef uint16_t arenaMark_t;
+
+/**
+ * @brief Creates an Arena with a storage taken from AllocBytes at boot time, accounted for ALLOC_TAG_ARENA
+ * 
+ * @param arena The Arena
+ * @param size The size of the storage in bytes
+ * @return Std_ReturnType a status
+ *          E_OK        If the Arena was created successfully
+ *          E_NOT_OK    If the storage could not be allocated
+ */
+extern Std_ReturnType Arena_Create(arena_t* arena, uint16_t size);
+
+/**
+ * @brief Creates an Arena with a storage taken from AllocTaggedBytes at boot time for an owner
+ * 
+ * @param arena The Arena
+ * @param size The size of the storage in bytes
+ * @param tag The owner of the Arena, one of the tags of Alloc_Cfg.h
+ * @return Std_ReturnType a status
+ *          E_OK        If the Arena was created successfully
+ *          E_NOT_OK    If the storage could not be allocated
+ */
+extern Std_ReturnType Arena_CreateTagged(arena_t* arena, uint16_t size, uint8_t tag);
+
+/**
+ * @brief Initializes an Arena on a storage the user provides
+ * 
+ * @param arena The Arena
+ * @param buffer The storage, word aligned
+ * @param size The size of the storage in bytes
+ * @return Std_ReturnType a status
+ *          E_OK        If the Arena was initialized successfully
+ *          E_NOT_OK    If the storage is not word aligned
+ */
+extern Std_ReturnType Arena_Init(arena_t* arena, uint8_t* buffer, uint16_t size);
+
+/**
+ * @brief Takes word aligned bytes from the Arena
+ * 
+ * @param arena The Arena
+ * @param ptr a place to return the address of the bytes
+ * @param sizeInBytes the size needed in bytes
+ * @return Std_ReturnType a status
+ *          E_OK        If the bytes were taken successfully
+ *          E_NOT_OK    If the Arena does not have enough bytes
+ */
+extern Std_ReturnType Arena_Alloc(arena_t* arena, void** ptr, uint16_t sizeInBytes);
+
+/**
+ * @brief Gets the current point of the Arena
+ * 
+ * @param arena The Arena
+ * @param mark a place to return the point in
+ * @return Std_ReturnType a status
+ *          E_OK        If the point was returned successfully
+ *          E_NOT_OK    If the mark is NULL
+ */
+extern Std_ReturnType Arena_Mark(arena_t* arena, arenaMark_t* mark);
+
+/**
+ * @brief Gives back all the bytes taken after a point
+ * 
+ * @param arena The Arena
+ * @param mark the point returned by Arena_Mark
+ * @return Std_ReturnType a status
+ *          E_OK        If the bytes were given back successfully
+ *          E_NOT_OK    If the point is after the current one
+ */
+extern Std_ReturnType Arena_Release(arena_t* arena, arenaMark_t mark);
+
+/**
+ * @brief Gets the accounting of the Arena
+ * 
+ * @param arena The Arena
+ * @param report a place to return the accounting in
+ * @return Std_ReturnType a status
+ *          E_OK        If the accounting was returned successfully
+ *          E_NOT_OK    If the report is NULL
+ */
+extern Std_ReturnType Arena_GetStats(arena_t* arena, allocReport_t* report);
+
+#endif
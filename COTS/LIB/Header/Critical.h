@@ -0,0 +1,83 @@
+/**
+ * @file Critical.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the nestable critical sections, they raise BASEPRI
+ *        so only the interrupts at CRITICAL_PRIORITY_LEVEL or below are held off,
+ *        and for the short sections that hold off all the interrupts with PRIMASK
+ *        (include Critical_Cfg.h before this file)
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef CRITICAL_H_
+#define CRITICAL_H_
+
+/* The STM32F1 implements the upper 4 bits of the priorities */
+#define CRITICAL_PRIORITY_BITS              4
+
+#if CRITICAL_PRIORITY_LEVEL < 1 || CRITICAL_PRIORITY_LEVEL > 15
+#error "CRITICAL_PRIORITY_LEVEL must be from 1 to 15, BASEPRI of 0 masks nothing"
+#endif
+
+#define CRITICAL_BASEPRI        ((uint32_t)CRITICAL_PRIORITY_LEVEL << (8 - CRITICAL_PRIORITY_BITS))
+
+/* A host build can define CRITICAL_TRACE and give the two functions to time the sections (Tools/CriticalBench.c) */
+#if !defined(__arm__) && defined(CRITICAL_TRACE)
+extern void Critical_TraceEnter(void);
+extern void Critical_TraceExit(void);
+#define CRITICAL_TRACE_ENTER()              Critical_TraceEnter()
+#define CRITICAL_TRACE_EXIT()               Critical_TraceExit()
+#else
+#define CRITICAL_TRACE_ENTER()
+#define CRITICAL_TRACE_EXIT()
+#endif
+
+/* Saves PRIMASK in a uint32_t and disables all the interrupts, the restore only enables them
+   again if they were enabled so the sections can be nested and used from the interrupts */
+#ifdef __arm__
+#define CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask)   __asm volatile ("mrs %0, primask\n\tcpsid i" : "=r" (primask) : : "memory")
+#define CRITICAL_RESTORE_INTERRUPTS(primask)            __asm volatile ("msr primask, %0" : : "r" (primask) : "memory")
+#else
+/* A host build (the tools) has no interrupts to disable */
+#define CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask)   do { (primask) = 0; CRITICAL_TRACE_ENTER(); __asm volatile ("" : : : "memory"); } while(0)
+#define CRITICAL_RESTORE_INTERRUPTS(primask)            do { (void)(primask); __asm volatile ("" : : : "memory"); CRITICAL_TRACE_EXIT(); } while(0)
+#endif
+
+/**
+ * @brief Enters a critical section, it only raises the masking level so it can be nested
+ * 
+ * @return uint32_t The masking level to give back to Critical_Exit
+ */
+static inline uint32_t Critical_Enter(void)
+{
+    uint32_t state = 0;
+#ifdef __arm__
+    /* BASEPRI_MAX only takes the new level if it masks more than the current one */
+    __asm volatile ("mrs %0, basepri\n\tmsr basepri_max, %1" : "=&r" (state) : "r" (CRITICAL_BASEPRI) : "memory");
+#else
+    /* A host build of the library (the tools) has no interrupts to mask */
+    CRITICAL_TRACE_ENTER();
+    __asm volatile ("" : : : "memory");
+#endif
+    return state;
+}
+
+/**
+ * @brief Leaves a critical section
+ * 
+ * @param state The masking level returned by Critical_Enter
+ */
+static inline void Critical_Exit(uint32_t state)
+{
+#ifdef __arm__
+    __asm volatile ("msr basepri, %0" : : "r" (state) : "memory");
+#else
+    (void)state;
+    __asm volatile ("" : : : "memory");
+    CRITICAL_TRACE_EXIT();
+#endif
+}
+
+#endif
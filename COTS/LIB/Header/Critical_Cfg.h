@@ -0,0 +1,18 @@
+/**
+ * @file Critical_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This file contains the configurations for the critical sections
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef CRITICAL_CFG_H_
+#define CRITICAL_CFG_H_
+
+/* The interrupts with a priority value (group and subpriority, 0 to 15) of this level or more are
+   masked in the critical sections, the ones above it (lower values) keep running (1 to 15) */
+#define CRITICAL_PRIORITY_LEVEL             4
+
+#endif
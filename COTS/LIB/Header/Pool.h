@@ -0,0 +1,76 @@
+/**
+ * @file Pool.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the fixed block Pool allocator
+ *        (blocks that can be freed and reused at run time, AllocBytes stays for the boot time allocations)
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef POOL_H_
+#define POOL_H_
+
+/**
+ * @brief A class of blocks of the same size
+ * 
+ */
+typedef struct
+{
+    uint16_t blockSize;         /* The size of a block in bytes (a multiple of 4) */
+    uint16_t numberOfBlocks;    /* The number of blocks */
+} poolClass_t;
+
+/**
+ * @brief Splits the pool memory into the configured blocks
+ * 
+ * @return Std_ReturnType a status
+ *          E_OK        If the pool was initialized successfully
+ *          E_NOT_OK    If the configured classes do not fit in the pool memory
+ */
+extern Std_ReturnType Pool_Init(void);
+
+/**
+ * @brief Allocates a block from the smallest class that fits and has a free block
+ * 
+ * @param ptr a place to return the address of the block
+ * @param sizeInBytes the size needed in bytes
+ * @return Std_ReturnType a status
+ *          E_OK        If a block was allocated successfully
+ *          E_NOT_OK    If no free block is large enough
+ */
+extern Std_ReturnType Pool_Alloc(void** ptr, uint16_t sizeInBytes);
+
+/**
+ * @brief Gives a block back to its class
+ * 
+ * @param ptr the address of the block
+ * @return Std_ReturnType a status
+ *          E_OK        If the block was freed successfully
+ *          E_NOT_OK    If the address is not a block of the pool or the block is already free
+ */
+extern Std_ReturnType Pool_Free(void* ptr);
+
+/**
+ * @brief Gets the accounting of a class, or of the whole pool for POOL_NUMBER_OF_CLASSES
+ * 
+ * @param classId the class in the order of the configurations
+ * @param report a place to return the accounting in
+ * @return Std_ReturnType a status
+ *          E_OK        If the accounting was returned successfully
+ *          E_NOT_OK    If the class is not configured or the report is NULL
+ */
+extern Std_ReturnType Pool_GetStats(uint8_t classId, allocReport_t* report);
+
+/**
+ * @brief Passes the accounting of every class then of the whole pool to a callback
+ * 
+ * @param dumpCb the function that receives the reports
+ * @return Std_ReturnType a status
+ *          E_OK        If the reports were passed successfully
+ *          E_NOT_OK    If the callback is NULL
+ */
+extern Std_ReturnType Pool_Dump(allocDumpCb_t dumpCb);
+
+#endif
@@ -0,0 +1,20 @@
+/**
+ * @file Pool_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This file contains the configurations for the Pool allocator
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef POOL_CFG_H_
+#define POOL_CFG_H_
+
+/* The number of block sizes, configured in Pool_Cfg.c from the smallest to the largest */
+#define POOL_NUMBER_OF_CLASSES          3
+
+/* The memory shared by all the blocks in bytes, it must hold every class */
+#define POOL_MEM_SIZE                   1792
+
+#endif
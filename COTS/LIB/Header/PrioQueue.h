@@ -0,0 +1,151 @@
+/**
+ * @file PrioQueue.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for a generic priority queue library (a binary min heap),
+ *        the element that compares first is always the one taken out
+ *        (the elements that compare equal do not keep their insertion order,
+ *        a queue shared with an interrupt must be used in a critical section)
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+
+#ifndef PRIO_QUEUE_H_
+#define PRIO_QUEUE_H_
+
+#define PRIO_QUEUE_ALIGNMENT        4
+/* The bytes the priority queue keeps before the data of the elements (the compare function then four 16 bit fields) */
+#define PRIO_QUEUE_HEADER_SIZE      (sizeof(void*) + 8)
+
+/* The size in words of the storage of a priority queue */
+#define PRIO_QUEUE_STORAGE_WORDS(sizeOfElement, numberOfElements)    \
+    ((PRIO_QUEUE_HEADER_SIZE + ((uint32_t)(sizeOfElement) * (numberOfElements)) + PRIO_QUEUE_ALIGNMENT - 1) / PRIO_QUEUE_ALIGNMENT)
+
+/**
+ * @brief Defines a priority queue with an exactly sized and word aligned storage at compile time
+ *        (use it at the file scope then create the priority queue with PRIO_QUEUE_CREATE_STATIC)
+ * 
+ * @param name The name of the priority queue
+ * @param type The type of one element
+ * @param numberOfElements The number of elements in the priority queue
+ */
+#define PRIO_QUEUE_DEFINE_STATIC(name, type, numberOfElements)                                          \
+    typedef char name##_sizeCheck[((numberOfElements) > 0 && (numberOfElements) <= 0xFFFFUL) ? 1 : -1]; \
+    static uint32_t name##_storage[PRIO_QUEUE_STORAGE_WORDS(sizeof(type), numberOfElements)];          \
+    static prioQueue_t name
+
+/**
+ * @brief Creates a priority queue defined by PRIO_QUEUE_DEFINE_STATIC
+ * 
+ * @param name The name of the priority queue
+ * @param type The type of one element, the same one it was defined with
+ * @param numberOfElements The number of elements in the priority queue, the same one it was defined with
+ * @param compare The function that orders the elements
+ */
+#define PRIO_QUEUE_CREATE_STATIC(name, type, numberOfElements, compare)                                 \
+    PrioQueue_CreateStatic(&(name), name##_storage, sizeof(name##_storage), sizeof(type), (numberOfElements), (compare))
+
+typedef void* prioQueue_t;
+
+/**
+ * @brief Orders two elements
+ * 
+ * @param first The first element
+ * @param second The second element
+ * @return sint8_t less than 0 if the first element comes before the second one,
+ *                 0 if they are equal and more than 0 if it comes after it
+ */
+typedef sint8_t (*prioQueueCmp_t)(const uint8_t* first, const uint8_t* second);
+
+/**
+ * @brief This function creates a new priority queue accounted for ALLOC_TAG_PRIO_QUEUE
+ * 
+ * @param prioQueue The address of the priority queue to be allocated
+ * @param sizeOfElement The size of one element in bytes
+ * @param numberOfElements The number of elements in a priority queue
+ * @param compare The function that orders the elements
+ * @return Std_ReturnType A status
+ *              E_OK            If the priority queue was created successfully
+ *              E_NOT_OK        If the function failed to create a priority queue
+ */
+extern Std_ReturnType PrioQueue_Create(prioQueue_t* prioQueue, uint16_t sizeOfElement, uint16_t numberOfElements, prioQueueCmp_t compare);
+
+/**
+ * @brief This function creates a new priority queue accounted for an owner
+ * 
+ * @param prioQueue The address of the priority queue to be allocated
+ * @param sizeOfElement The size of one element in bytes
+ * @param numberOfElements The number of elements in a priority queue
+ * @param compare The function that orders the elements
+ * @param tag The owner of the priority queue, one of the tags of Alloc_Cfg.h
+ * @return Std_ReturnType A status
+ *              E_OK            If the priority queue was created successfully
+ *              E_NOT_OK        If the function failed to create a priority queue
+ */
+extern Std_ReturnType PrioQueue_CreateTagged(prioQueue_t* prioQueue, uint16_t sizeOfElement, uint16_t numberOfElements,
+                                            prioQueueCmp_t compare, uint8_t tag);
+
+/**
+ * @brief This function creates a new priority queue in a storage the user provides
+ *        (use PRIO_QUEUE_DEFINE_STATIC and PRIO_QUEUE_CREATE_STATIC to get an exactly sized storage)
+ * 
+ * @param prioQueue The address of the priority queue to be created
+ * @param storage The storage of the priority queue, word aligned
+ * @param storageSize The size of the storage in bytes
+ * @param sizeOfElement The size of one element in bytes
+ * @param numberOfElements The number of elements in a priority queue
+ * @param compare The function that orders the elements
+ * @return Std_ReturnType A status
+ *              E_OK            If the priority queue was created successfully
+ *              E_NOT_OK        If the storage can not hold the priority queue
+ */
+extern Std_ReturnType PrioQueue_CreateStatic(prioQueue_t* prioQueue, void* storage, uint32_t storageSize,
+                                             uint16_t sizeOfElement, uint16_t numberOfElements, prioQueueCmp_t compare);
+
+/**
+ * @brief Adds an element to a priority queue in O(log n)
+ * 
+ * @param prioQueue The priority queue to add the element in
+ * @param data The data of the element to add
+ * @return Std_ReturnType A status
+ *              E_OK            If the element was added successfully
+ *              E_NOT_OK        If the priority queue is full
+ */
+extern Std_ReturnType PrioQueue_Insert(prioQueue_t* prioQueue, const uint8_t* data);
+
+/**
+ * @brief Gets the first element and removes it from the priority queue in O(log n)
+ * 
+ * @param prioQueue The priority queue to get the element from
+ * @param data The place to get the element in
+ * @return Std_ReturnType A status
+ *              E_OK            If the element was removed successfully
+ *              E_NOT_OK        If the priority queue is empty
+ */
+extern Std_ReturnType PrioQueue_ExtractMin(prioQueue_t* prioQueue, uint8_t* data);
+
+/**
+ * @brief Gets a pointer to the first element without removing it from the priority queue
+ * 
+ * @param prioQueue The priority queue
+ * @param ptr A place to return the pointer to the element in
+ * @return Std_ReturnType A status
+ *              E_OK            If an element was found
+ *              E_NOT_OK        If the priority queue is empty
+ */
+extern Std_ReturnType PrioQueue_PeekMin(prioQueue_t* prioQueue, uint8_t** ptr);
+
+/**
+ * @brief Gets the number of elements in the priority queue
+ * 
+ * @param prioQueue The priority queue
+ * @param size A place to return the number of elements in
+ * @return Std_ReturnType A status
+ *              E_OK            If the function was executed successfully
+ *              E_NOT_OK        If the function failed execute
+ */
+extern Std_ReturnType PrioQueue_GetSize(prioQueue_t* prioQueue, uint16_t* size);
+
+#endif
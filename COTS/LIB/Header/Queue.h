@@ -2,6 +2,8 @@
  * @file Queue.h
  * @author Mark Attia (markjosephattia@gmail.com)
  * @brief This is the user interface for a generic queue library
+ *        (one producer and one consumer, like a task and an interrupt, can use a queue at the same time,
+ *        two producers or two consumers of the same queue need a lock of their own around the calls)
  * @version 0.1
  * @date 2020-04-08
  * 
@@ -18,10 +20,44 @@
 #define QUEUE_IS_FULL           0
 #define QUEUE_NOT_FULL          !QUEUE_IS_FULL
 
+#define QUEUE_ALIGNMENT         4
+/* The bytes the queue keeps before the data of the elements */
+#define QUEUE_HEADER_SIZE       12
+/* The most data bytes a queue can hold, the offsets in the data are 16 bits */
+#define QUEUE_MAX_DATA_SIZE     0xFFFFUL
+
+/* The size in words of the storage of a queue */
+#define QUEUE_STORAGE_WORDS(sizeOfElement, numberOfElements)    \
+    ((QUEUE_HEADER_SIZE + ((uint32_t)(sizeOfElement) * (numberOfElements)) + QUEUE_ALIGNMENT - 1) / QUEUE_ALIGNMENT)
+
+/**
+ * @brief Defines a queue with an exactly sized and word aligned storage at compile time
+ *        (use it at the file scope then create the queue with QUEUE_CREATE_STATIC)
+ * 
+ * @param name The name of the queue
+ * @param type The type of one element
+ * @param numberOfElements The number of elements in the queue
+ */
+#define QUEUE_DEFINE_STATIC(name, type, numberOfElements)                                               \
+    typedef char name##_sizeCheck[((numberOfElements) > 0 &&                                            \
+                                   (uint32_t)sizeof(type) * (numberOfElements) <= QUEUE_MAX_DATA_SIZE) ? 1 : -1]; \
+    static uint32_t name##_storage[QUEUE_STORAGE_WORDS(sizeof(type), numberOfElements)];                \
+    static queue_t name
+
+/**
+ * @brief Creates a queue defined by QUEUE_DEFINE_STATIC
+ * 
+ * @param name The name of the queue
+ * @param type The type of one element, the same one it was defined with
+ * @param numberOfElements The number of elements in the queue, the same one it was defined with
+ */
+#define QUEUE_CREATE_STATIC(name, type, numberOfElements)                                               \
+    Queue_CreateStatic(&(name), name##_storage, sizeof(name##_storage), sizeof(type), (numberOfElements))
+
 typedef void* queue_t;
 
 /**
- * @brief This function creates a new queue
+ * @brief This function creates a new queue accounted for ALLOC_TAG_QUEUE
  * 
  * @param queue The address of the queue to be allocated
  * @param sizeOfElement The size of one element in bytes
@@ -33,7 +69,35 @@ typedef void* queue_t;
 extern Std_ReturnType Queue_CreateQueue(queue_t* queue, uint16_t sizeOfElement, uint16_t numberOfElements);
 
 /**
- * @brief Adds an Element to a queue
+ * @brief This function creates a new queue accounted for an owner
+ * 
+ * @param queue The address of the queue to be allocated
+ * @param sizeOfElement The size of one element in bytes
+ * @param numberOfElements The number of elements in a queue
+ * @param tag The owner of the queue, one of the tags of Alloc_Cfg.h
+ * @return Std_ReturnType A status
+ *              E_OK            If the Queue was created successfully
+ *              E_NOT_OK        If the function failed to create a Queue
+ */
+extern Std_ReturnType Queue_CreateQueueTagged(queue_t* queue, uint16_t sizeOfElement, uint16_t numberOfElements, uint8_t tag);
+
+/**
+ * @brief This function creates a new queue in a storage the user provides
+ *        (use QUEUE_DEFINE_STATIC and QUEUE_CREATE_STATIC to get an exactly sized storage)
+ * 
+ * @param queue The address of the queue to be created
+ * @param storage The storage of the queue, word aligned
+ * @param storageSize The size of the storage in bytes
+ * @param sizeOfElement The size of one element in bytes
+ * @param numberOfElements The number of elements in a queue
+ * @return Std_ReturnType A status
+ *              E_OK            If the Queue was created successfully
+ *              E_NOT_OK        If the storage can not hold the Queue
+ */
+extern Std_ReturnType Queue_CreateStatic(queue_t* queue, void* storage, uint32_t storageSize, uint16_t sizeOfElement, uint16_t numberOfElements);
+
+/**
+ * @brief Adds an Element to a queue (only called by the one producer of the queue)
  * 
  * @param queue The queue to add element in
  * @param data The data of the element to add
@@ -44,7 +108,7 @@ extern Std_ReturnType Queue_CreateQueue(queue_t* queue, uint16_t sizeOfElement,
 extern Std_ReturnType Queue_Enqueue(queue_t* queue, uint8_t* data);
 
 /**
- * @brief Gets an element and removes it from the queue
+ * @brief Gets an element and removes it from the queue (only called by the one consumer of the queue)
  * 
  * @param queue The queue to get element from
  * @param data The data of the element to get
@@ -54,6 +118,76 @@ extern Std_ReturnType Queue_Enqueue(queue_t* queue, uint8_t* data);
  */
 extern Std_ReturnType Queue_Dequeue(queue_t* queue, uint8_t* data);
 
+/**
+ * @brief Adds many elements to a queue, as many as there is space for (only called by the one producer of the queue)
+ * 
+ * @param queue The queue to add the elements in
+ * @param data The data of the elements to add
+ * @param count The number of elements to add
+ * @param added A place to return the number of elements added in (can be NULL)
+ * @return Std_ReturnType A status
+ *              E_OK            If all the elements were added successfully
+ *              E_NOT_OK        If the queue did not have space for all of them
+ */
+extern Std_ReturnType Queue_EnqueueN(queue_t* queue, uint8_t* data, uint16_t count, uint16_t* added);
+
+/**
+ * @brief Gets many elements and removes them from the queue, as many as there are up to a count (only called by the one consumer of the queue)
+ * 
+ * @param queue The queue to get the elements from
+ * @param data The place to get the elements in
+ * @param count The number of elements to get
+ * @param removed A place to return the number of elements removed in (can be NULL)
+ * @return Std_ReturnType A status
+ *              E_OK            If all the elements were removed successfully
+ *              E_NOT_OK        If the queue had less elements
+ */
+extern Std_ReturnType Queue_DequeueN(queue_t* queue, uint8_t* data, uint16_t count, uint16_t* removed);
+
+/**
+ * @brief Gets a pointer to the free slot at the back of the queue to fill the element in place,
+ * the element is added by Queue_CommitBack (only called by the one producer of the queue)
+ * 
+ * @param queue The queue
+ * @param ptr A place to return the pointer to the slot in
+ * @return Std_ReturnType A status
+ *              E_OK            If there is a free slot
+ *              E_NOT_OK        If the queue is full
+ */
+extern Std_ReturnType Queue_ReserveBack(queue_t* queue, uint8_t** ptr);
+
+/**
+ * @brief Adds the element filled in the slot given by Queue_ReserveBack to the queue (only called by the one producer of the queue)
+ * 
+ * @param queue The queue
+ * @return Std_ReturnType A status
+ *              E_OK            If the element was added successfully
+ *              E_NOT_OK        If the queue is full
+ */
+extern Std_ReturnType Queue_CommitBack(queue_t* queue);
+
+/**
+ * @brief Gets a pointer to the element at the front of the queue to use it in place,
+ * the element is removed by Queue_ReleaseFront (only called by the one consumer of the queue)
+ * 
+ * @param queue The queue
+ * @param ptr A place to return the pointer to the element in
+ * @return Std_ReturnType A status
+ *              E_OK            If an element was found
+ *              E_NOT_OK        If the queue is empty
+ */
+extern Std_ReturnType Queue_PeekFront(queue_t* queue, uint8_t** ptr);
+
+/**
+ * @brief Removes the element at the front of the queue without copying it (only called by the one consumer of the queue)
+ * 
+ * @param queue The queue
+ * @return Std_ReturnType A status
+ *              E_OK            If the element was removed successfully
+ *              E_NOT_OK        If the queue is empty
+ */
+extern Std_ReturnType Queue_ReleaseFront(queue_t* queue);
+
 /**
  * @brief Gets the element from the front of the queue without removing it from the queue
  * 
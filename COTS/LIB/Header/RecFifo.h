@@ -0,0 +1,122 @@
+/**
+ * @file RecFifo.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for a single producer single consumer record FIFO,
+ *        records of any length are kept back to back with their length before them and
+ *        a record never wraps around the end of the storage, so it can be handed to a DMA in place
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+
+#ifndef REC_FIFO_H_
+#define REC_FIFO_H_
+
+/* The bytes taken by the length before every record, the records start word aligned after it */
+#define REC_FIFO_HEADER_SIZE    4
+
+/* The bytes a record of a length takes in the storage */
+#define REC_FIFO_RECORD_SIZE(length)    (REC_FIFO_HEADER_SIZE + (((uint32_t)(length) + 3) & ~(uint32_t)3))
+
+/**
+ * @brief The record FIFO, the offsets are wrapped to the start when they reach the end of the storage
+ * 
+ */
+typedef struct
+{
+    uint32_t* buffer;           /* The storage, word aligned */
+    uint32_t size;              /* The size of the storage in bytes (a multiple of 4) */
+    volatile uint32_t head;     /* The offset to write the next record at, only changed by the producer */
+    volatile uint32_t tail;     /* The offset of the first record, only changed by the consumer */
+    uint32_t reserved;          /* The offset of the reserved record, only used by the producer */
+    uint32_t reservedLength;    /* The length that was reserved, only used by the producer */
+} recFifo_t;
+
+/**
+ * @brief Initializes a record FIFO on a storage
+ * 
+ * @param fifo The record FIFO
+ * @param buffer The storage of the record FIFO
+ * @param size The size of the storage in bytes (a multiple of 4)
+ * @return Std_ReturnType A status
+ *              E_OK            If the record FIFO was initialized successfully
+ *              E_NOT_OK        If the size is not a multiple of 4
+ */
+extern Std_ReturnType RecFifo_Init(recFifo_t* fifo, uint32_t* buffer, uint32_t size);
+
+/**
+ * @brief Gets a contiguous and word aligned place for a record to fill it in place,
+ * the record is added by RecFifo_Commit (producer only)
+ * 
+ * @param fifo The record FIFO
+ * @param length The most bytes the record can have
+ * @param ptr A place to return the pointer to the record in
+ * @return Std_ReturnType A status
+ *              E_OK            If the place was reserved
+ *              E_NOT_OK        If the record FIFO does not have space for the record
+ */
+extern Std_ReturnType RecFifo_Reserve(recFifo_t* fifo, uint16_t length, uint8_t** ptr);
+
+/**
+ * @brief Adds the record filled in the place given by RecFifo_Reserve (producer only)
+ * 
+ * @param fifo The record FIFO
+ * @param length The length of the record, not more than the reserved length
+ * @return Std_ReturnType A status
+ *              E_OK            If the record was added successfully
+ *              E_NOT_OK        If the length is more than the reserved length
+ */
+extern Std_ReturnType RecFifo_Commit(recFifo_t* fifo, uint16_t length);
+
+/**
+ * @brief Copies a record in the record FIFO (producer only)
+ * 
+ * @param fifo The record FIFO
+ * @param data The bytes of the record
+ * @param length The length of the record
+ * @return Std_ReturnType A status
+ *              E_OK            If the record was added successfully
+ *              E_NOT_OK        If the record FIFO does not have space for the record
+ */
+extern Std_ReturnType RecFifo_Write(recFifo_t* fifo, const uint8_t* data, uint16_t length);
+
+/**
+ * @brief Gets a pointer to the first record to use it in place,
+ * the record is removed by RecFifo_Release (consumer only)
+ * 
+ * @param fifo The record FIFO
+ * @param ptr A place to return the pointer to the record in
+ * @param length A place to return the length of the record in
+ * @return Std_ReturnType A status
+ *              E_OK            If a record was found
+ *              E_NOT_OK        If the record FIFO is empty
+ */
+extern Std_ReturnType RecFifo_Peek(recFifo_t* fifo, uint8_t** ptr, uint16_t* length);
+
+/**
+ * @brief Removes the first record (consumer only)
+ * 
+ * @param fifo The record FIFO
+ * @return Std_ReturnType A status
+ *              E_OK            If the record was removed successfully
+ *              E_NOT_OK        If the record FIFO is empty
+ */
+extern Std_ReturnType RecFifo_Release(recFifo_t* fifo);
+
+/**
+ * @brief Copies the first record and removes it (consumer only)
+ * 
+ * @param fifo The record FIFO
+ * @param data A buffer to copy the record in
+ * @param maxLength The size of the buffer
+ * @param length A place to return the length of the record in
+ * @return Std_ReturnType A status
+ *              E_OK            If the record was read successfully
+ *              E_NOT_OK        If the record FIFO is empty or the record is longer than the buffer,
+ *                              a longer record stays in the record FIFO and its length is returned
+ */
+extern Std_ReturnType RecFifo_Read(recFifo_t* fifo, uint8_t* data, uint16_t maxLength, uint16_t* length);
+
+#endif
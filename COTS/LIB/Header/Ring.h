@@ -0,0 +1,133 @@
+/**
+ * @file Ring.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for a single producer single consumer ring buffer
+ *        (an interrupt can produce while a task consumes, or the other way around, without locking)
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+
+#ifndef RING_H_
+#define RING_H_
+
+/* Keeps the compiler from moving the buffer accesses across the index updates,
+   the Cortex-M3 is a single core so nothing more is needed */
+#define RING_BARRIER()          __asm volatile ("" : : : "memory")
+
+/**
+ * @brief The ring buffer, the indexes run freely and are masked on every access
+ * 
+ */
+typedef struct
+{
+    uint8_t* buffer;            /* The storage, its size is a power of two */
+    uint32_t mask;              /* The size of the storage minus one */
+    volatile uint32_t head;     /* The write index, only changed by the producer */
+    volatile uint32_t tail;     /* The read index, only changed by the consumer */
+} ring_t;
+
+/**
+ * @brief Initializes a ring buffer on a storage
+ * 
+ * @param ring The ring buffer
+ * @param buffer The storage of the ring buffer
+ * @param size The size of the storage in bytes (a power of two)
+ * @return Std_ReturnType A status
+ *              E_OK            If the ring buffer was initialized successfully
+ *              E_NOT_OK        If the size is not a power of two
+ */
+extern Std_ReturnType Ring_Init(ring_t* ring, uint8_t* buffer, uint32_t size);
+
+/**
+ * @brief Writes as many bytes as there is space for (producer only)
+ * 
+ * @param ring The ring buffer
+ * @param data The bytes to write
+ * @param length The number of bytes to write
+ * @param written A place to return the number of bytes written in (can be NULL)
+ * @return Std_ReturnType A status
+ *              E_OK            If all the bytes were written
+ *              E_NOT_OK        If the ring buffer did not have space for all of them
+ */
+extern Std_ReturnType Ring_Write(ring_t* ring, const uint8_t* data, uint32_t length, uint32_t* written);
+
+/**
+ * @brief Reads as many bytes as there are up to a length (consumer only)
+ * 
+ * @param ring The ring buffer
+ * @param data A buffer to read the bytes in
+ * @param length The number of bytes to read
+ * @param read A place to return the number of bytes read in (can be NULL)
+ * @return Std_ReturnType A status
+ *              E_OK            If all the bytes were read
+ *              E_NOT_OK        If the ring buffer had less bytes
+ */
+extern Std_ReturnType Ring_Read(ring_t* ring, uint8_t* data, uint32_t length, uint32_t* read);
+
+/**
+ * @brief Writes a byte (producer only)
+ * 
+ * @param ring The ring buffer
+ * @param data The byte to write
+ * @return Std_ReturnType A status
+ *              E_OK            If the byte was written
+ *              E_NOT_OK        If the ring buffer is full
+ */
+static inline Std_ReturnType Ring_Put(ring_t* ring, uint8_t data)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t head = ring->head;
+    if(head - ring->tail <= ring->mask)
+    {
+        ring->buffer[head & ring->mask] = data;
+        /* The byte must be in place before the consumer can see it */
+        RING_BARRIER();
+        ring->head = head + 1;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Reads a byte (consumer only)
+ * 
+ * @param ring The ring buffer
+ * @param data A place to return the byte in
+ * @return Std_ReturnType A status
+ *              E_OK            If a byte was read
+ *              E_NOT_OK        If the ring buffer is empty
+ */
+static inline Std_ReturnType Ring_Get(ring_t* ring, uint8_t* data)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t tail = ring->tail;
+    if(ring->head != tail)
+    {
+        *data = ring->buffer[tail & ring->mask];
+        /* The byte must be taken before the producer can write over it */
+        RING_BARRIER();
+        ring->tail = tail + 1;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the number of bytes in the ring buffer
+ * 
+ * @param ring The ring buffer
+ * @param count A place to return the number of bytes in
+ * @return Std_ReturnType A status
+ *              E_OK            If the function was executed successfully
+ *              E_NOT_OK        If the function failed execute
+ */
+static inline Std_ReturnType Ring_GetCount(ring_t* ring, uint32_t* count)
+{
+    *count = ring->head - ring->tail;
+    return E_OK;
+}
+
+#endif
@@ -1,7 +1,9 @@
 #ifndef STD_TYPES_H
 #define STD_TYPES_H
 
+#ifndef NULL
 #define NULL                            ((void*)0)
+#endif
 
 typedef unsigned char                   u8;
 typedef unsigned char                   uint8_t;
@@ -11,14 +13,36 @@ typedef unsigned short int              u16;
 typedef unsigned short int              uint16_t;
 typedef signed short int                s16;
 typedef signed short int                sint16_t;
+/* The compiler gives the 32 bit types so the library also builds on 64 bit hosts,
+   on the target they are the same long int types */
+#if defined(__UINT32_TYPE__) && defined(__INT32_TYPE__)
+typedef __UINT32_TYPE__                 u32;
+typedef __UINT32_TYPE__                 uint32_t;
+typedef __INT32_TYPE__                  s32;
+typedef __INT32_TYPE__                  sint32_t;
+#else
 typedef unsigned long int               u32;
 typedef unsigned long int               uint32_t;
 typedef signed long int                 s32;
 typedef signed long int                 sint32_t;
+#endif
+#if defined(__UINT64_TYPE__) && defined(__INT64_TYPE__)
+typedef __UINT64_TYPE__                 u64;
+typedef __UINT64_TYPE__                 uint64_t;
+typedef __INT64_TYPE__                  s64;
+typedef __INT64_TYPE__                  sint64_t;
+#else
 typedef unsigned long long int          u64;
 typedef unsigned long long int          uint64_t;
 typedef signed long long int            s64;
 typedef signed long long int            sint64_t;
+#endif
+/* An unsigned integer as wide as a pointer for the address arithmetic */
+#if defined(__UINTPTR_TYPE__)
+typedef __UINTPTR_TYPE__                uintptr_t;
+#else
+typedef unsigned long int               uintptr_t;
+#endif
 
 typedef float                           f32;
 typedef double                          f64;
@@ -9,12 +9,21 @@
  * 
  */
 #include "Std_Types.h"
+#include "Alloc_Cfg.h"
+#include "Alloc.h"
 
-#define MEM_MAX_SIZE        50000
+#define MEM_ALIGNMENT       4
 
-static uint8_t Alloc_rawMem[MEM_MAX_SIZE];
+extern const char* const Alloc_tagName[ALLOC_NUMBER_OF_TAGS];
+
+static uint8_t Alloc_rawMem[MEM_MAX_SIZE] __attribute__((aligned(MEM_ALIGNMENT)));
 static uint16_t Alloc_memItr;
 
+/* The bytes of every owner, nothing is freed so the bytes in use are also the peak */
+static uint32_t Alloc_tagBytes[ALLOC_NUMBER_OF_TAGS];
+static uint32_t Alloc_tagFailures[ALLOC_NUMBER_OF_TAGS];
+static uint32_t Alloc_failures;
+
 /**
  * @brief This function allocates free bytes for the user
  * 
@@ -25,13 +34,122 @@ static uint16_t Alloc_memItr;
  *          E_NOT_OK    If the function failed to allocate bytes 
  */
 extern Std_ReturnType AllocBytes(void** ptr, uint16_t sizeInBytets)
+{
+    return AllocTaggedBytes(ptr, sizeInBytets, ALLOC_TAG_UNTAGGED);
+}
+
+/**
+ * @brief This function allocates free bytes and accounts them for an owner
+ * 
+ * @param ptr a place to return the address of the allocated bytes
+ * @param sizeInBytets the size of memory allocation in bytes
+ * @param tag the owner of the allocation
+ *          ALLOC_TAG_UNTAGGED
+ *          ALLOC_TAG_QUEUE
+ *          ALLOC_TAG_PRIO_QUEUE
+ *          ALLOC_TAG_ARENA
+ *          or an owner tag added in Alloc_Cfg.h
+ * @return Std_ReturnType a status
+ *          E_OK        If bytes allocated successfully
+ *          E_NOT_OK    If the function failed to allocate bytes 
+ */
+extern Std_ReturnType AllocTaggedBytes(void** ptr, uint16_t sizeInBytets, uint8_t tag)
 {
     Std_ReturnType error = E_NOT_OK;
-    if (Alloc_memItr + sizeInBytets < MEM_MAX_SIZE)
+    /* Every block starts word aligned so structures can be used in place */
+    uint32_t size = ((uint32_t)sizeInBytets + MEM_ALIGNMENT - 1) & ~(uint32_t)(MEM_ALIGNMENT - 1);
+    if(tag >= ALLOC_NUMBER_OF_TAGS)
+    {
+        tag = ALLOC_TAG_UNTAGGED;
+    }
+    if (ptr && Alloc_memItr + size < MEM_MAX_SIZE)
     {
         *ptr = (void*)&(Alloc_rawMem[Alloc_memItr]);
-        Alloc_memItr += sizeInBytets;
+        Alloc_memItr += size;
+        Alloc_tagBytes[tag] += size;
+        error = E_OK;
+    }
+    else
+    {
+        Alloc_tagFailures[tag]++;
+        Alloc_failures++;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the accounting of all the allocations
+ * 
+ * @param report a place to return the accounting in
+ * @return Std_ReturnType a status
+ *          E_OK        If the accounting was returned successfully
+ *          E_NOT_OK    If the report is NULL
+ */
+Std_ReturnType Alloc_GetStats(allocReport_t* report)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(report)
+    {
+        report->name = "Total";
+        report->id = ALLOC_NUMBER_OF_TAGS;
+        report->inUse = Alloc_memItr;
+        report->peak = Alloc_memItr;
+        report->failures = Alloc_failures;
+        /* The allocation must leave the last byte free */
+        report->headroom = MEM_MAX_SIZE - 1 - Alloc_memItr;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the accounting of the allocations of an owner
+ * 
+ * @param tag the owner of the allocations
+ * @param report a place to return the accounting in
+ * @return Std_ReturnType a status
+ *          E_OK        If the accounting was returned successfully
+ *          E_NOT_OK    If the tag is not configured or the report is NULL
+ */
+Std_ReturnType Alloc_GetTagStats(uint8_t tag, allocReport_t* report)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(report && tag < ALLOC_NUMBER_OF_TAGS)
+    {
+        report->name = Alloc_tagName[tag];
+        report->id = tag;
+        report->inUse = Alloc_tagBytes[tag];
+        report->peak = Alloc_tagBytes[tag];
+        report->failures = Alloc_tagFailures[tag];
+        report->headroom = MEM_MAX_SIZE - 1 - Alloc_memItr;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Passes the accounting of every owner then of all the allocations to a callback
+ * 
+ * @param dumpCb the function that receives the reports
+ * @return Std_ReturnType a status
+ *          E_OK        If the reports were passed successfully
+ *          E_NOT_OK    If the callback is NULL
+ */
+Std_ReturnType Alloc_Dump(allocDumpCb_t dumpCb)
+{
+    Std_ReturnType error = E_NOT_OK;
+    allocReport_t report;
+    uint8_t tag;
+    if(dumpCb)
+    {
+        for(tag=0; tag<ALLOC_NUMBER_OF_TAGS; tag++)
+        {
+            Alloc_GetTagStats(tag, &report);
+            dumpCb(&report);
+        }
+        Alloc_GetStats(&report);
+        dumpCb(&report);
         error = E_OK;
     }
     return error;
-}
\ No newline at end of file
+}
@@ -0,0 +1,22 @@
+/**
+ * @file Alloc_Cfg.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief Those are the User's configurations for the Allocation tool
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "Alloc_Cfg.h"
+#include "Alloc.h"
+
+/* The names of the tags in the order of their ids */
+const char* const Alloc_tagName[ALLOC_NUMBER_OF_TAGS] =
+{
+    "Untagged",
+    "Queue",
+    "Priority queue",
+    "Arena"
+};
@@ -0,0 +1,175 @@
+/**
+ * @file Arena.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the Arena allocator
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "Alloc_Cfg.h"
+#include "Alloc.h"
+#include "Arena.h"
+
+#define ARENA_ALIGNMENT                 4
+
+/**
+ * @brief Creates an Arena with a storage taken from AllocBytes at boot time, accounted for ALLOC_TAG_ARENA
+ * 
+ * @param arena The Arena
+ * @param size The size of the storage in bytes
+ * @return Std_ReturnType a status
+ *          E_OK        If the Arena was created successfully
+ *          E_NOT_OK    If the storage could not be allocated
+ */
+Std_ReturnType Arena_Create(arena_t* arena, uint16_t size)
+{
+    return Arena_CreateTagged(arena, size, ALLOC_TAG_ARENA);
+}
+
+/**
+ * @brief Creates an Arena with a storage taken from AllocTaggedBytes at boot time for an owner
+ * 
+ * @param arena The Arena
+ * @param size The size of the storage in bytes
+ * @param tag The owner of the Arena, one of the tags of Alloc_Cfg.h
+ * @return Std_ReturnType a status
+ *          E_OK        If the Arena was created successfully
+ *          E_NOT_OK    If the storage could not be allocated
+ */
+Std_ReturnType Arena_CreateTagged(arena_t* arena, uint16_t size, uint8_t tag)
+{
+    Std_ReturnType error = E_NOT_OK;
+    void* buffer;
+    if(arena && E_OK == AllocTaggedBytes(&buffer, size, tag))
+    {
+        error = Arena_Init(arena, (uint8_t*)buffer, size);
+    }
+    return error;
+}
+
+/**
+ * @brief Initializes an Arena on a storage the user provides
+ * 
+ * @param arena The Arena
+ * @param buffer The storage, word aligned
+ * @param size The size of the storage in bytes
+ * @return Std_ReturnType a status
+ *          E_OK        If the Arena was initialized successfully
+ *          E_NOT_OK    If the storage is not word aligned
+ */
+Std_ReturnType Arena_Init(arena_t* arena, uint8_t* buffer, uint16_t size)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(arena && buffer && 0 == ((uintptr_t)buffer % ARENA_ALIGNMENT))
+    {
+        arena->buffer = buffer;
+        /* Only whole words are handed out */
+        arena->size = size & ~(uint16_t)(ARENA_ALIGNMENT - 1);
+        arena->used = 0;
+        arena->peak = 0;
+        arena->failures = 0;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Takes word aligned bytes from the Arena
+ * 
+ * @param arena The Arena
+ * @param ptr a place to return the address of the bytes
+ * @param sizeInBytes the size needed in bytes
+ * @return Std_ReturnType a status
+ *          E_OK        If the bytes were taken successfully
+ *          E_NOT_OK    If the Arena does not have enough bytes
+ */
+Std_ReturnType Arena_Alloc(arena_t* arena, void** ptr, uint16_t sizeInBytes)
+{
+    Std_ReturnType error = E_NOT_OK;
+    /* The offset stays word aligned so every allocation starts on a word */
+    uint32_t size = ((uint32_t)sizeInBytes + ARENA_ALIGNMENT - 1) & ~(uint32_t)(ARENA_ALIGNMENT - 1);
+    if(size <= (uint32_t)(arena->size - arena->used))
+    {
+        *ptr = (void*)&arena->buffer[arena->used];
+        arena->used += (uint16_t)size;
+        if(arena->used > arena->peak)
+        {
+            arena->peak = arena->used;
+        }
+        error = E_OK;
+    }
+    else
+    {
+        arena->failures++;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the current point of the Arena
+ * 
+ * @param arena The Arena
+ * @param mark a place to return the point in
+ * @return Std_ReturnType a status
+ *          E_OK        If the point was returned successfully
+ *          E_NOT_OK    If the mark is NULL
+ */
+Std_ReturnType Arena_Mark(arena_t* arena, arenaMark_t* mark)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(mark)
+    {
+        *mark = arena->used;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gives back all the bytes taken after a point
+ * 
+ * @param arena The Arena
+ * @param mark the point returned by Arena_Mark
+ * @return Std_ReturnType a status
+ *          E_OK        If the bytes were given back successfully
+ *          E_NOT_OK    If the point is after the current one
+ */
+Std_ReturnType Arena_Release(arena_t* arena, arenaMark_t mark)
+{
+    Std_ReturnType error = E_NOT_OK;
+    /* A point after the current one was already given back by an outer release */
+    if(mark <= arena->used)
+    {
+        arena->used = mark;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the accounting of the Arena
+ * 
+ * @param arena The Arena
+ * @param report a place to return the accounting in
+ * @return Std_ReturnType a status
+ *          E_OK        If the accounting was returned successfully
+ *          E_NOT_OK    If the report is NULL
+ */
+Std_ReturnType Arena_GetStats(arena_t* arena, allocReport_t* report)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(report)
+    {
+        report->name = "Arena";
+        report->id = 0;
+        report->inUse = arena->used;
+        report->peak = arena->peak;
+        report->failures = arena->failures;
+        report->headroom = arena->size - arena->used;
+        error = E_OK;
+    }
+    return error;
+}
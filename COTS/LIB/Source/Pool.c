@@ -0,0 +1,272 @@
+/**
+ * @file Pool.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the fixed block Pool allocator
+ * @version 0.1
+ * @date 2020-04-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "Std_Types.h"
+#include "Critical_Cfg.h"
+#include "Critical.h"
+#include "Alloc.h"
+#include "Pool_Cfg.h"
+#include "Pool.h"
+
+#define POOL_ALIGNMENT                  4
+#define POOL_MAP_WORDS                  (((POOL_MEM_SIZE / POOL_ALIGNMENT) + 31) / 32)
+
+/* The bit of the aligned word a block starts at */
+#define POOL_MAP_BIT(address)           ((uint32_t)((address) - Pool_rawMem) / POOL_ALIGNMENT)
+
+/**
+ * @brief A free block, the link to the next free block is kept in the block itself
+ *
+ */
+typedef struct poolBlock
+{
+    struct poolBlock* next;     /* The next free block of the class */
+} poolBlock_t;
+
+extern const poolClass_t Pool_classes[POOL_NUMBER_OF_CLASSES];
+
+static uint8_t Pool_rawMem[POOL_MEM_SIZE] __attribute__((aligned(POOL_ALIGNMENT)));
+
+static uint8_t* Pool_classStart[POOL_NUMBER_OF_CLASSES];       /* The first block of every class */
+static uint8_t* Pool_classEnd[POOL_NUMBER_OF_CLASSES];         /* The end of the last block of every class */
+static poolBlock_t* Pool_freeList[POOL_NUMBER_OF_CLASSES];      /* The free blocks of every class */
+static uint32_t Pool_inUseMap[POOL_MAP_WORDS];                  /* Set at the start of every allocated block so a double free is refused */
+
+static uint16_t Pool_blocksInUse[POOL_NUMBER_OF_CLASSES];       /* The allocated blocks of every class */
+static uint16_t Pool_peakBlocks[POOL_NUMBER_OF_CLASSES];        /* The most blocks of every class that were allocated at once */
+static uint32_t Pool_classFailures[POOL_NUMBER_OF_CLASSES];     /* The times the smallest class that fits had no free block */
+static uint32_t Pool_bytesInUse;
+static uint32_t Pool_peakBytes;
+static uint32_t Pool_failures;                                  /* The allocations that got no block at all */
+
+/**
+ * @brief Splits the pool memory into the configured blocks
+ *
+ * @return Std_ReturnType a status
+ *          E_OK        If the pool was initialized successfully
+ *          E_NOT_OK    If the configured classes do not fit in the pool memory
+ */
+Std_ReturnType Pool_Init(void)
+{
+    Std_ReturnType error = E_OK;
+    uint32_t memItr = 0;
+    uint8_t classItr;
+    uint16_t blockItr;
+    uint16_t mapItr;
+    poolBlock_t* block;
+    for(mapItr=0; mapItr<POOL_MAP_WORDS; mapItr++)
+    {
+        Pool_inUseMap[mapItr] = 0;
+    }
+    for(classItr=0; classItr<POOL_NUMBER_OF_CLASSES; classItr++)
+    {
+        Pool_freeList[classItr] = NULL;
+        Pool_blocksInUse[classItr] = 0;
+        Pool_peakBlocks[classItr] = 0;
+        Pool_classFailures[classItr] = 0;
+        Pool_classStart[classItr] = &Pool_rawMem[memItr];
+        Pool_classEnd[classItr] = &Pool_rawMem[memItr];
+        /* A block must hold the free list link and keep the next block aligned */
+        if(E_OK == error && Pool_classes[classItr].blockSize >= sizeof(poolBlock_t) &&
+           0 == (Pool_classes[classItr].blockSize % POOL_ALIGNMENT) &&
+           memItr + ((uint32_t)Pool_classes[classItr].blockSize * Pool_classes[classItr].numberOfBlocks) <= POOL_MEM_SIZE)
+        {
+            /* Link the blocks from the last one so the list starts at the lowest address */
+            for(blockItr=Pool_classes[classItr].numberOfBlocks; blockItr>0; blockItr--)
+            {
+                block = (poolBlock_t*)&Pool_rawMem[memItr + ((uint32_t)(blockItr - 1) * Pool_classes[classItr].blockSize)];
+                block->next = Pool_freeList[classItr];
+                Pool_freeList[classItr] = block;
+            }
+            memItr += (uint32_t)Pool_classes[classItr].blockSize * Pool_classes[classItr].numberOfBlocks;
+            Pool_classEnd[classItr] = &Pool_rawMem[memItr];
+        }
+        else
+        {
+            error = E_NOT_OK;
+        }
+    }
+    Pool_bytesInUse = 0;
+    Pool_peakBytes = 0;
+    Pool_failures = 0;
+    return error;
+}
+
+/**
+ * @brief Allocates a block from the smallest class that fits and has a free block
+ *
+ * @param ptr a place to return the address of the block
+ * @param sizeInBytes the size needed in bytes
+ * @return Std_ReturnType a status
+ *          E_OK        If a block was allocated successfully
+ *          E_NOT_OK    If no free block is large enough
+ */
+Std_ReturnType Pool_Alloc(void** ptr, uint16_t sizeInBytes)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t primask;
+    uint32_t mapBit;
+    uint8_t classItr;
+    uint8_t fits = 0;
+    poolBlock_t* block;
+    if(ptr)
+    {
+        CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+        for(classItr=0; classItr<POOL_NUMBER_OF_CLASSES; classItr++)
+        {
+            block = Pool_freeList[classItr];
+            if(Pool_classes[classItr].blockSize >= sizeInBytes)
+            {
+                if(block)
+                {
+                    Pool_freeList[classItr] = block->next;
+                    mapBit = POOL_MAP_BIT((uint8_t*)block);
+                    Pool_inUseMap[mapBit / 32] |= (uint32_t)1 << (mapBit % 32);
+                    *ptr = (void*)block;
+                    Pool_blocksInUse[classItr]++;
+                    if(Pool_blocksInUse[classItr] > Pool_peakBlocks[classItr])
+                    {
+                        Pool_peakBlocks[classItr] = Pool_blocksInUse[classItr];
+                    }
+                    Pool_bytesInUse += Pool_classes[classItr].blockSize;
+                    if(Pool_bytesInUse > Pool_peakBytes)
+                    {
+                        Pool_peakBytes = Pool_bytesInUse;
+                    }
+                    error = E_OK;
+                    break;
+                }
+                if(0 == fits)
+                {
+                    /* The request spills over to a larger class or fails */
+                    Pool_classFailures[classItr]++;
+                    fits = 1;
+                }
+            }
+        }
+        if(E_NOT_OK == error)
+        {
+            Pool_failures++;
+        }
+        CRITICAL_RESTORE_INTERRUPTS(primask);
+    }
+    return error;
+}
+
+/**
+ * @brief Gives a block back to its class
+ *
+ * @param ptr the address of the block
+ * @return Std_ReturnType a status
+ *          E_OK        If the block was freed successfully
+ *          E_NOT_OK    If the address is not a block of the pool or the block is already free
+ */
+Std_ReturnType Pool_Free(void* ptr)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t primask;
+    uint32_t mapBit;
+    uint8_t classItr;
+    uint8_t* address = (uint8_t*)ptr;
+    poolBlock_t* block;
+    for(classItr=0; classItr<POOL_NUMBER_OF_CLASSES; classItr++)
+    {
+        /* The class is found by the address range, the address must be the start of a block */
+        if(address >= Pool_classStart[classItr] && address < Pool_classEnd[classItr] &&
+           0 == ((uint32_t)(address - Pool_classStart[classItr]) % Pool_classes[classItr].blockSize))
+        {
+            block = (poolBlock_t*)address;
+            mapBit = POOL_MAP_BIT(address);
+            CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+            /* A free block would be linked twice and the counters would wrap */
+            if(Pool_inUseMap[mapBit / 32] & ((uint32_t)1 << (mapBit % 32)))
+            {
+                Pool_inUseMap[mapBit / 32] &= ~((uint32_t)1 << (mapBit % 32));
+                block->next = Pool_freeList[classItr];
+                Pool_freeList[classItr] = block;
+                Pool_blocksInUse[classItr]--;
+                Pool_bytesInUse -= Pool_classes[classItr].blockSize;
+                error = E_OK;
+            }
+            CRITICAL_RESTORE_INTERRUPTS(primask);
+            break;
+        }
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the accounting of a class, or of the whole pool for POOL_NUMBER_OF_CLASSES
+ *
+ * @param classId the class in the order of the configurations
+ * @param report a place to return the accounting in
+ * @return Std_ReturnType a status
+ *          E_OK        If the accounting was returned successfully
+ *          E_NOT_OK    If the class is not configured or the report is NULL
+ */
+Std_ReturnType Pool_GetStats(uint8_t classId, allocReport_t* report)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t primask;
+    uint8_t classItr;
+    if(report && classId <= POOL_NUMBER_OF_CLASSES)
+    {
+        report->id = classId;
+        CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+        if(classId < POOL_NUMBER_OF_CLASSES)
+        {
+            report->name = "Pool";
+            report->inUse = (uint32_t)Pool_blocksInUse[classId] * Pool_classes[classId].blockSize;
+            report->peak = (uint32_t)Pool_peakBlocks[classId] * Pool_classes[classId].blockSize;
+            report->failures = Pool_classFailures[classId];
+            report->headroom = (uint32_t)(Pool_classes[classId].numberOfBlocks - Pool_blocksInUse[classId]) * Pool_classes[classId].blockSize;
+        }
+        else
+        {
+            report->name = "Pool total";
+            report->inUse = Pool_bytesInUse;
+            report->peak = Pool_peakBytes;
+            report->failures = Pool_failures;
+            report->headroom = 0;
+            for(classItr=0; classItr<POOL_NUMBER_OF_CLASSES; classItr++)
+            {
+                report->headroom += (uint32_t)(Pool_classes[classItr].numberOfBlocks - Pool_blocksInUse[classItr]) * Pool_classes[classItr].blockSize;
+            }
+        }
+        CRITICAL_RESTORE_INTERRUPTS(primask);
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Passes the accounting of every class then of the whole pool to a callback
+ *
+ * @param dumpCb the function that receives the reports
+ * @return Std_ReturnType a status
+ *          E_OK        If the reports were passed successfully
+ *          E_NOT_OK    If the callback is NULL
+ */
+Std_ReturnType Pool_Dump(allocDumpCb_t dumpCb)
+{
+    Std_ReturnType error = E_NOT_OK;
+    allocReport_t report;
+    uint8_t classItr;
+    if(dumpCb)
+    {
+        for(classItr=0; classItr<=POOL_NUMBER_OF_CLASSES; classItr++)
+        {
+            Pool_GetStats(classItr, &report);
+            dumpCb(&report);
+        }
+        error = E_OK;
+    }
+    return error;
+}
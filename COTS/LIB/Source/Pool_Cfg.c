@@ -0,0 +1,22 @@
+/**
+ * @file Pool_Cfg.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief Those are the User's configurations for the Pool allocator
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "Alloc.h"
+#include "Pool_Cfg.h"
+#include "Pool.h"
+
+/* The block sizes are multiples of 4 bytes sorted from the smallest */
+const poolClass_t Pool_classes[POOL_NUMBER_OF_CLASSES] =
+{
+    {16, 16},
+    {64, 8},
+    {256, 4}
+};
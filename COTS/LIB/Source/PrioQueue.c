@@ -0,0 +1,257 @@
+/**
+ * @file PrioQueue.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the priority queue library
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "Alloc_Cfg.h"
+#include "Alloc.h"
+#include "PrioQueue.h"
+
+/* The elements are a binary heap in an array, the children of element i are 2i+1 and 2i+2 */
+typedef struct
+{
+    prioQueueCmp_t compare;
+    uint16_t nElements;
+    uint16_t maxElements;
+    uint16_t elementSize;
+    uint16_t reserved;
+    uint8_t data[];
+}prioQueueData_t;
+
+/* The storage macros size the priority queues with PRIO_QUEUE_HEADER_SIZE so it must match the layout */
+typedef char PrioQueue_headerSizeCheck[(__builtin_offsetof(prioQueueData_t, data) == PRIO_QUEUE_HEADER_SIZE) ? 1 : -1];
+
+/**
+ * @brief Copies bytes
+ * 
+ * @param dest The place to copy to
+ * @param src The place to copy from
+ * @param size The number of bytes
+ */
+static void PrioQueue_Copy(uint8_t* dest, const uint8_t* src, uint16_t size)
+{
+    uint16_t i;
+    for(i=0; i<size; i++)
+    {
+        dest[i] = src[i];
+    }
+}
+
+/**
+ * @brief Sets up an empty priority queue
+ * 
+ * @param myQueue The priority queue
+ * @param sizeOfElement The size of one element in bytes
+ * @param numberOfElements The number of elements in a priority queue
+ * @param compare The function that orders the elements
+ */
+static void PrioQueue_Setup(prioQueueData_t* myQueue, uint16_t sizeOfElement, uint16_t numberOfElements, prioQueueCmp_t compare)
+{
+    myQueue->compare = compare;
+    myQueue->nElements = 0;
+    myQueue->maxElements = numberOfElements;
+    myQueue->elementSize = sizeOfElement;
+    myQueue->reserved = 0;
+}
+
+/**
+ * @brief This function creates a new priority queue accounted for ALLOC_TAG_PRIO_QUEUE
+ * 
+ * @param prioQueue The address of the priority queue to be allocated
+ * @param sizeOfElement The size of one element in bytes
+ * @param numberOfElements The number of elements in a priority queue
+ * @param compare The function that orders the elements
+ * @return Std_ReturnType A status
+ *              E_OK            If the priority queue was created successfully
+ *              E_NOT_OK        If the function failed to create a priority queue
+ */
+Std_ReturnType PrioQueue_Create(prioQueue_t* prioQueue, uint16_t sizeOfElement, uint16_t numberOfElements, prioQueueCmp_t compare)
+{
+    return PrioQueue_CreateTagged(prioQueue, sizeOfElement, numberOfElements, compare, ALLOC_TAG_PRIO_QUEUE);
+}
+
+/**
+ * @brief This function creates a new priority queue accounted for an owner
+ * 
+ * @param prioQueue The address of the priority queue to be allocated
+ * @param sizeOfElement The size of one element in bytes
+ * @param numberOfElements The number of elements in a priority queue
+ * @param compare The function that orders the elements
+ * @param tag The owner of the priority queue, one of the tags of Alloc_Cfg.h
+ * @return Std_ReturnType A status
+ *              E_OK            If the priority queue was created successfully
+ *              E_NOT_OK        If the function failed to create a priority queue
+ */
+Std_ReturnType PrioQueue_CreateTagged(prioQueue_t* prioQueue, uint16_t sizeOfElement, uint16_t numberOfElements,
+                                     prioQueueCmp_t compare, uint8_t tag)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t dataSize = (uint32_t)sizeOfElement * numberOfElements;
+    if(prioQueue && compare && sizeOfElement && numberOfElements && PRIO_QUEUE_HEADER_SIZE + dataSize <= 0xFFFFUL)
+    {
+        error = AllocTaggedBytes(prioQueue, (uint16_t)(PRIO_QUEUE_HEADER_SIZE + dataSize), tag);
+    }
+    if(E_OK == error)
+    {
+        PrioQueue_Setup((prioQueueData_t*)*prioQueue, sizeOfElement, numberOfElements, compare);
+    }
+    return error;
+}
+
+/**
+ * @brief This function creates a new priority queue in a storage the user provides
+ *        (use PRIO_QUEUE_DEFINE_STATIC and PRIO_QUEUE_CREATE_STATIC to get an exactly sized storage)
+ * 
+ * @param prioQueue The address of the priority queue to be created
+ * @param storage The storage of the priority queue, word aligned
+ * @param storageSize The size of the storage in bytes
+ * @param sizeOfElement The size of one element in bytes
+ * @param numberOfElements The number of elements in a priority queue
+ * @param compare The function that orders the elements
+ * @return Std_ReturnType A status
+ *              E_OK            If the priority queue was created successfully
+ *              E_NOT_OK        If the storage can not hold the priority queue
+ */
+Std_ReturnType PrioQueue_CreateStatic(prioQueue_t* prioQueue, void* storage, uint32_t storageSize,
+                                      uint16_t sizeOfElement, uint16_t numberOfElements, prioQueueCmp_t compare)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t dataSize = (uint32_t)sizeOfElement * numberOfElements;
+    if(prioQueue && storage && compare && 0 == ((uintptr_t)storage % PRIO_QUEUE_ALIGNMENT) &&
+       sizeOfElement && numberOfElements && PRIO_QUEUE_HEADER_SIZE + dataSize <= storageSize)
+    {
+        PrioQueue_Setup((prioQueueData_t*)storage, sizeOfElement, numberOfElements, compare);
+        *prioQueue = storage;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Adds an element to a priority queue in O(log n)
+ * 
+ * @param prioQueue The priority queue to add the element in
+ * @param data The data of the element to add
+ * @return Std_ReturnType A status
+ *              E_OK            If the element was added successfully
+ *              E_NOT_OK        If the priority queue is full
+ */
+Std_ReturnType PrioQueue_Insert(prioQueue_t* prioQueue, const uint8_t* data)
+{
+    Std_ReturnType error = E_NOT_OK;
+    prioQueueData_t* myQueue = (prioQueueData_t*)*prioQueue;
+    uint32_t size = myQueue->elementSize;
+    uint32_t hole;
+    uint32_t parent;
+    if(myQueue->nElements < myQueue->maxElements)
+    {
+        /* Move the hole up from the end while the parent comes after the new element */
+        hole = myQueue->nElements;
+        while(hole > 0)
+        {
+            parent = (hole - 1) >> 1;
+            if(myQueue->compare(data, &myQueue->data[parent * size]) >= 0)
+            {
+                break;
+            }
+            PrioQueue_Copy(&myQueue->data[hole * size], &myQueue->data[parent * size], (uint16_t)size);
+            hole = parent;
+        }
+        PrioQueue_Copy(&myQueue->data[hole * size], data, (uint16_t)size);
+        myQueue->nElements++;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the first element and removes it from the priority queue in O(log n)
+ * 
+ * @param prioQueue The priority queue to get the element from
+ * @param data The place to get the element in
+ * @return Std_ReturnType A status
+ *              E_OK            If the element was removed successfully
+ *              E_NOT_OK        If the priority queue is empty
+ */
+Std_ReturnType PrioQueue_ExtractMin(prioQueue_t* prioQueue, uint8_t* data)
+{
+    Std_ReturnType error = E_NOT_OK;
+    prioQueueData_t* myQueue = (prioQueueData_t*)*prioQueue;
+    uint32_t size = myQueue->elementSize;
+    uint32_t count;
+    uint32_t hole = 0;
+    uint32_t child;
+    const uint8_t* last;
+    if(myQueue->nElements != 0)
+    {
+        PrioQueue_Copy(data, myQueue->data, (uint16_t)size);
+        myQueue->nElements--;
+        count = myQueue->nElements;
+        /* The last element stays in its slot, out of the heap, until the hole from the root reaches its place */
+        last = &myQueue->data[count * size];
+        child = 1;
+        while(child < count)
+        {
+            if(child + 1 < count && myQueue->compare(&myQueue->data[(child + 1) * size], &myQueue->data[child * size]) < 0)
+            {
+                child++;
+            }
+            if(myQueue->compare(&myQueue->data[child * size], last) >= 0)
+            {
+                break;
+            }
+            PrioQueue_Copy(&myQueue->data[hole * size], &myQueue->data[child * size], (uint16_t)size);
+            hole = child;
+            child = (hole << 1) + 1;
+        }
+        if(count != 0)
+        {
+            PrioQueue_Copy(&myQueue->data[hole * size], last, (uint16_t)size);
+        }
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets a pointer to the first element without removing it from the priority queue
+ * 
+ * @param prioQueue The priority queue
+ * @param ptr A place to return the pointer to the element in
+ * @return Std_ReturnType A status
+ *              E_OK            If an element was found
+ *              E_NOT_OK        If the priority queue is empty
+ */
+Std_ReturnType PrioQueue_PeekMin(prioQueue_t* prioQueue, uint8_t** ptr)
+{
+    Std_ReturnType error = E_NOT_OK;
+    prioQueueData_t* myQueue = (prioQueueData_t*)*prioQueue;
+    if(myQueue->nElements != 0)
+    {
+        *ptr = myQueue->data;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the number of elements in the priority queue
+ * 
+ * @param prioQueue The priority queue
+ * @param size A place to return the number of elements in
+ * @return Std_ReturnType A status
+ *              E_OK            If the function was executed successfully
+ *              E_NOT_OK        If the function failed execute
+ */
+Std_ReturnType PrioQueue_GetSize(prioQueue_t* prioQueue, uint16_t* size)
+{
+    prioQueueData_t* myQueue = (prioQueueData_t*)*prioQueue;
+    *size = myQueue->nElements;
+    return E_OK;
+}
@@ -9,25 +9,76 @@
  * 
  */
 #include "Std_Types.h"
+#include "Alloc_Cfg.h"
 #include "Alloc.h"
+#include "Critical_Cfg.h"
+#include "Critical.h"
 #include "Queue.h"
 
-#define MAXIMUM_SIZE_OF_DATA_BYTES                      1000
-
+/* The producer only moves back and the consumer only moves front, so a task and an interrupt
+   can share a queue with only the element count updated in a critical section,
+   the count is volatile as the other side changes it between the checks and the copies */
 typedef struct
 {
-    uint16_t nElements;
+    volatile uint16_t nElements;
     uint16_t maxElements;
     uint16_t front;
     uint16_t back;
     uint16_t elementSize;
     uint16_t lastElement;
-    uint8_t data[MAXIMUM_SIZE_OF_DATA_BYTES];
+    uint8_t data[];
 }queueData_t;
 
+/* The storage macros size the queues with QUEUE_HEADER_SIZE so it must match the layout,
+   the data must also start word aligned for the word copies */
+typedef char Queue_headerSizeCheck[(__builtin_offsetof(queueData_t, data) == QUEUE_HEADER_SIZE &&
+                                    0 == (QUEUE_HEADER_SIZE % QUEUE_ALIGNMENT)) ? 1 : -1];
+
+/**
+ * @brief Copies bytes, a word at a time when both addresses are word aligned
+ * 
+ * @param dest The place to copy to
+ * @param src The place to copy from
+ * @param size The number of bytes
+ */
+static void Queue_Copy(uint8_t* dest, const uint8_t* src, uint16_t size)
+{
+    uint16_t i = 0;
+    uint16_t words;
+    if(0 == (((uintptr_t)dest | (uintptr_t)src) & 3))
+    {
+        words = size >> 2;
+        for(; i<words; i++)
+        {
+            ((uint32_t*)dest)[i] = ((const uint32_t*)src)[i];
+        }
+        i <<= 2;
+    }
+    for(; i<size; i++)
+    {
+        dest[i] = src[i];
+    }
+}
+
+/**
+ * @brief Sets up an empty queue
+ * 
+ * @param myQueue The queue
+ * @param sizeOfElement The size of one element in bytes
+ * @param numberOfElements The number of elements in a queue
+ */
+static void Queue_Setup(queueData_t* myQueue, uint16_t sizeOfElement, uint16_t numberOfElements)
+{
+    myQueue->maxElements = numberOfElements;
+    myQueue->elementSize = sizeOfElement;
+    myQueue->front = 0;
+    myQueue->back = 0;
+    myQueue->nElements = 0;
+    myQueue->lastElement =  sizeOfElement * (numberOfElements-1);
+}
 
 /**
- * @brief This function creates a new queue
+ * @brief This function creates a new queue accounted for ALLOC_TAG_QUEUE
  * 
  * @param queue The address of the queue to be allocated
  * @param sizeOfElement The size of one element in bytes
@@ -38,17 +89,60 @@ typedef struct
  */
 Std_ReturnType Queue_CreateQueue(queue_t* queue, uint16_t sizeOfElement, uint16_t numberOfElements)
 {
-    Std_ReturnType error;
-    error = AllocBytes(queue, (sizeOfElement*numberOfElements)+12);
-    queueData_t* myQueue = (queueData_t*)*queue;
+    return Queue_CreateQueueTagged(queue, sizeOfElement, numberOfElements, ALLOC_TAG_QUEUE);
+}
+
+/**
+ * @brief This function creates a new queue accounted for an owner
+ * 
+ * @param queue The address of the queue to be allocated
+ * @param sizeOfElement The size of one element in bytes
+ * @param numberOfElements The number of elements in a queue
+ * @param tag The owner of the queue, one of the tags of Alloc_Cfg.h
+ * @return Std_ReturnType A status
+ *              E_OK            If the Queue was created successfully
+ *              E_NOT_OK        If the function failed to create a Queue
+ */
+Std_ReturnType Queue_CreateQueueTagged(queue_t* queue, uint16_t sizeOfElement, uint16_t numberOfElements, uint8_t tag)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t dataSize = (uint32_t)sizeOfElement * numberOfElements;
+    /* The data offsets are 16 bits and the allocation size is 16 bits */
+    if(sizeOfElement && numberOfElements && QUEUE_HEADER_SIZE + dataSize <= QUEUE_MAX_DATA_SIZE)
+    {
+        error = AllocTaggedBytes(queue, (uint16_t)(QUEUE_HEADER_SIZE + dataSize), tag);
+    }
     if(error == E_OK)
     {
-        myQueue->maxElements = numberOfElements;
-        myQueue->elementSize = sizeOfElement;
-        myQueue->front = 0;
-        myQueue->back = 0;
-        myQueue->nElements = 0;
-        myQueue->lastElement =  sizeOfElement * (numberOfElements-1);
+        Queue_Setup((queueData_t*)*queue, sizeOfElement, numberOfElements);
+    }
+    return error;
+}
+
+/**
+ * @brief This function creates a new queue in a storage the user provides
+ *        (use QUEUE_DEFINE_STATIC and QUEUE_CREATE_STATIC to get an exactly sized storage)
+ * 
+ * @param queue The address of the queue to be created
+ * @param storage The storage of the queue, word aligned
+ * @param storageSize The size of the storage in bytes
+ * @param sizeOfElement The size of one element in bytes
+ * @param numberOfElements The number of elements in a queue
+ * @return Std_ReturnType A status
+ *              E_OK            If the Queue was created successfully
+ *              E_NOT_OK        If the storage can not hold the Queue
+ */
+Std_ReturnType Queue_CreateStatic(queue_t* queue, void* storage, uint32_t storageSize, uint16_t sizeOfElement, uint16_t numberOfElements)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t dataSize = (uint32_t)sizeOfElement * numberOfElements;
+    if(queue && storage && 0 == ((uintptr_t)storage % QUEUE_ALIGNMENT) &&
+       sizeOfElement && numberOfElements && dataSize <= QUEUE_MAX_DATA_SIZE &&
+       QUEUE_HEADER_SIZE + dataSize <= storageSize)
+    {
+        Queue_Setup((queueData_t*)storage, sizeOfElement, numberOfElements);
+        *queue = storage;
+        error = E_OK;
     }
     return error;
 }
@@ -65,14 +159,11 @@ Std_ReturnType Queue_CreateQueue(queue_t* queue, uint16_t sizeOfElement, uint16_
 Std_ReturnType Queue_Enqueue(queue_t* queue, uint8_t* data)
 {
     Std_ReturnType error = E_NOT_OK;
-    uint8_t i;
+    uint32_t state;
     queueData_t* myQueue = (queueData_t*)*queue;
     if(myQueue->nElements < myQueue->maxElements)
     {
-        for(i=0; i<myQueue->elementSize; i++)
-        {
-            myQueue->data[myQueue->back + i] = data[i]; 
-        }
+        Queue_Copy(&myQueue->data[myQueue->back], data, myQueue->elementSize);
         if(myQueue->back == myQueue->lastElement)
         {
             myQueue->back = 0;
@@ -81,7 +172,9 @@ Std_ReturnType Queue_Enqueue(queue_t* queue, uint8_t* data)
         {
             myQueue->back += myQueue->elementSize;
         }
+        state = Critical_Enter();
         myQueue->nElements++;
+        Critical_Exit(state);
         error = E_OK;
     }
     return error;
@@ -99,14 +192,223 @@ Std_ReturnType Queue_Enqueue(queue_t* queue, uint8_t* data)
 Std_ReturnType Queue_Dequeue(queue_t* queue, uint8_t* data)
 {
     Std_ReturnType error = E_NOT_OK;
-    uint8_t i;
+    uint32_t state;
     queueData_t* myQueue = (queueData_t*)*queue;
     if(myQueue->nElements != 0)
     {
-        for(i=0; i<myQueue->elementSize; i++)
+        Queue_Copy(data, &myQueue->data[myQueue->front], myQueue->elementSize);
+        if(myQueue->front == myQueue->lastElement)
+        {
+            myQueue->front = 0;
+        }
+        else
         {
-            data[i] = myQueue->data[myQueue->front + i]; 
+            myQueue->front += myQueue->elementSize;
         }
+        state = Critical_Enter();
+        myQueue->nElements--;
+        Critical_Exit(state);
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Adds many elements to a queue, as many as there is space for
+ * 
+ * @param queue The queue to add the elements in
+ * @param data The data of the elements to add
+ * @param count The number of elements to add
+ * @param added A place to return the number of elements added in (can be NULL)
+ * @return Std_ReturnType A status
+ *              E_OK            If all the elements were added successfully
+ *              E_NOT_OK        If the queue did not have space for all of them
+ */
+Std_ReturnType Queue_EnqueueN(queue_t* queue, uint8_t* data, uint16_t count, uint16_t* added)
+{
+    Std_ReturnType error = E_OK;
+    uint32_t state;
+    queueData_t* myQueue = (queueData_t*)*queue;
+    uint16_t capacity = myQueue->lastElement + myQueue->elementSize;
+    /* The consumer only makes more space, so one read of the count is enough */
+    uint16_t space = myQueue->maxElements - myQueue->nElements;
+    uint32_t next;
+    uint16_t bytes;
+    uint16_t first;
+    if(count > space)
+    {
+        count = space;
+        error = E_NOT_OK;
+    }
+    bytes = count * myQueue->elementSize;
+    /* At most two copies, up to the end of the data then from its start */
+    first = capacity - myQueue->back;
+    if(first > bytes)
+    {
+        first = bytes;
+    }
+    Queue_Copy(&myQueue->data[myQueue->back], data, first);
+    Queue_Copy(myQueue->data, &data[first], bytes - first);
+    /* The sum can pass 16 bits before it wraps */
+    next = (uint32_t)myQueue->back + bytes;
+    if(next >= capacity)
+    {
+        next -= capacity;
+    }
+    myQueue->back = (uint16_t)next;
+    state = Critical_Enter();
+    myQueue->nElements += count;
+    Critical_Exit(state);
+    if(added)
+    {
+        *added = count;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets many elements and removes them from the queue, as many as there are up to a count
+ * 
+ * @param queue The queue to get the elements from
+ * @param data The place to get the elements in
+ * @param count The number of elements to get
+ * @param removed A place to return the number of elements removed in (can be NULL)
+ * @return Std_ReturnType A status
+ *              E_OK            If all the elements were removed successfully
+ *              E_NOT_OK        If the queue had less elements
+ */
+Std_ReturnType Queue_DequeueN(queue_t* queue, uint8_t* data, uint16_t count, uint16_t* removed)
+{
+    Std_ReturnType error = E_OK;
+    uint32_t state;
+    queueData_t* myQueue = (queueData_t*)*queue;
+    uint16_t capacity = myQueue->lastElement + myQueue->elementSize;
+    /* The producer only adds elements, so one read of the count is enough */
+    uint16_t available = myQueue->nElements;
+    uint32_t next;
+    uint16_t bytes;
+    uint16_t first;
+    if(count > available)
+    {
+        count = available;
+        error = E_NOT_OK;
+    }
+    bytes = count * myQueue->elementSize;
+    /* At most two copies, up to the end of the data then from its start */
+    first = capacity - myQueue->front;
+    if(first > bytes)
+    {
+        first = bytes;
+    }
+    Queue_Copy(data, &myQueue->data[myQueue->front], first);
+    Queue_Copy(&data[first], myQueue->data, bytes - first);
+    /* The sum can pass 16 bits before it wraps */
+    next = (uint32_t)myQueue->front + bytes;
+    if(next >= capacity)
+    {
+        next -= capacity;
+    }
+    myQueue->front = (uint16_t)next;
+    state = Critical_Enter();
+    myQueue->nElements -= count;
+    Critical_Exit(state);
+    if(removed)
+    {
+        *removed = count;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets a pointer to the free slot at the back of the queue to fill the element in place,
+ * the element is added by Queue_CommitBack
+ * 
+ * @param queue The queue
+ * @param ptr A place to return the pointer to the slot in
+ * @return Std_ReturnType A status
+ *              E_OK            If there is a free slot
+ *              E_NOT_OK        If the queue is full
+ */
+Std_ReturnType Queue_ReserveBack(queue_t* queue, uint8_t** ptr)
+{
+    Std_ReturnType error = E_NOT_OK;
+    queueData_t* myQueue = (queueData_t*)*queue;
+    if(myQueue->nElements < myQueue->maxElements)
+    {
+        *ptr = &myQueue->data[myQueue->back];
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Adds the element filled in the slot given by Queue_ReserveBack to the queue
+ * 
+ * @param queue The queue
+ * @return Std_ReturnType A status
+ *              E_OK            If the element was added successfully
+ *              E_NOT_OK        If the queue is full
+ */
+Std_ReturnType Queue_CommitBack(queue_t* queue)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t state;
+    queueData_t* myQueue = (queueData_t*)*queue;
+    if(myQueue->nElements < myQueue->maxElements)
+    {
+        if(myQueue->back == myQueue->lastElement)
+        {
+            myQueue->back = 0;
+        }
+        else
+        {
+            myQueue->back += myQueue->elementSize;
+        }
+        state = Critical_Enter();
+        myQueue->nElements++;
+        Critical_Exit(state);
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets a pointer to the element at the front of the queue to use it in place,
+ * the element is removed by Queue_ReleaseFront
+ * 
+ * @param queue The queue
+ * @param ptr A place to return the pointer to the element in
+ * @return Std_ReturnType A status
+ *              E_OK            If an element was found
+ *              E_NOT_OK        If the queue is empty
+ */
+Std_ReturnType Queue_PeekFront(queue_t* queue, uint8_t** ptr)
+{
+    Std_ReturnType error = E_NOT_OK;
+    queueData_t* myQueue = (queueData_t*)*queue;
+    if(myQueue->nElements != 0)
+    {
+        *ptr = &myQueue->data[myQueue->front];
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Removes the element at the front of the queue without copying it
+ * 
+ * @param queue The queue
+ * @return Std_ReturnType A status
+ *              E_OK            If the element was removed successfully
+ *              E_NOT_OK        If the queue is empty
+ */
+Std_ReturnType Queue_ReleaseFront(queue_t* queue)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t state;
+    queueData_t* myQueue = (queueData_t*)*queue;
+    if(myQueue->nElements != 0)
+    {
         if(myQueue->front == myQueue->lastElement)
         {
             myQueue->front = 0;
@@ -115,7 +417,9 @@ Std_ReturnType Queue_Dequeue(queue_t* queue, uint8_t* data)
         {
             myQueue->front += myQueue->elementSize;
         }
+        state = Critical_Enter();
         myQueue->nElements--;
+        Critical_Exit(state);
         error = E_OK;
     }
     return error;
@@ -133,14 +437,10 @@ Std_ReturnType Queue_Dequeue(queue_t* queue, uint8_t* data)
 Std_ReturnType Queue_GetFront(queue_t* queue, uint8_t* data)
 {
     Std_ReturnType error = E_NOT_OK;
-    uint8_t i;
     queueData_t* myQueue = (queueData_t*)*queue;
     if(myQueue->nElements != 0)
     {
-        for(i=0; i<myQueue->elementSize; i++)
-        {
-            data[i] = myQueue->data[myQueue->front + i]; 
-        }
+        Queue_Copy(data, &myQueue->data[myQueue->front], myQueue->elementSize);
         error = E_OK;
     }
     return error;
@@ -158,13 +458,17 @@ Std_ReturnType Queue_GetFront(queue_t* queue, uint8_t* data)
 Std_ReturnType Queue_GetBack(queue_t* queue, uint8_t* data)
 {
     Std_ReturnType error = E_NOT_OK;
-    uint8_t i;
     queueData_t* myQueue = (queueData_t*)*queue;
     if(myQueue->nElements != 0)
     {
-        for(i=0; i<myQueue->elementSize; i++)
+        /* The back index is where the next element goes, the last one is before it */
+        if(0 == myQueue->back)
+        {
+            Queue_Copy(data, &myQueue->data[myQueue->lastElement], myQueue->elementSize);
+        }
+        else
         {
-            data[i] = myQueue->data[myQueue->back - myQueue->elementSize + i]; 
+            Queue_Copy(data, &myQueue->data[myQueue->back - myQueue->elementSize], myQueue->elementSize);
         }
         error = E_OK;
     }
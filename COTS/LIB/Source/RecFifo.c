@@ -0,0 +1,271 @@
+/**
+ * @file RecFifo.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the single producer single consumer record FIFO
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "RecFifo.h"
+
+/* The length left at the end of the storage when a record did not fit there, the next one is at the start */
+#define REC_FIFO_PAD                    0xFFFFFFFFUL
+
+#define REC_FIFO_NO_RECORD              0xFFFFFFFFUL
+
+/* Keeps the compiler from moving the storage accesses across the offset updates */
+#define REC_FIFO_BARRIER()              __asm volatile ("" : : : "memory")
+
+/**
+ * @brief Gets the offset that follows a record, wrapped to the start at the end of the storage
+ * 
+ * @param fifo The record FIFO
+ * @param offset The offset of the record
+ * @param length The length of the record
+ * @return uint32_t The next offset
+ */
+static uint32_t RecFifo_Next(recFifo_t* fifo, uint32_t offset, uint32_t length)
+{
+    offset += REC_FIFO_RECORD_SIZE(length);
+    if(offset == fifo->size)
+    {
+        offset = 0;
+    }
+    return offset;
+}
+
+/**
+ * @brief Gets the offset of the first record, skipping the pad at the end of the storage (consumer only)
+ * 
+ * @param fifo The record FIFO
+ * @return uint32_t The offset or REC_FIFO_NO_RECORD if the record FIFO is empty
+ */
+static uint32_t RecFifo_Front(recFifo_t* fifo)
+{
+    uint32_t tail = fifo->tail;
+    if(fifo->head != tail && REC_FIFO_PAD == fifo->buffer[tail >> 2])
+    {
+        tail = 0;
+        fifo->tail = 0;
+    }
+    if(fifo->head == tail)
+    {
+        tail = REC_FIFO_NO_RECORD;
+    }
+    /* The record must be read after the head that shows it */
+    REC_FIFO_BARRIER();
+    return tail;
+}
+
+/**
+ * @brief Initializes a record FIFO on a storage
+ * 
+ * @param fifo The record FIFO
+ * @param buffer The storage of the record FIFO
+ * @param size The size of the storage in bytes (a multiple of 4)
+ * @return Std_ReturnType A status
+ *              E_OK            If the record FIFO was initialized successfully
+ *              E_NOT_OK        If the size is not a multiple of 4
+ */
+Std_ReturnType RecFifo_Init(recFifo_t* fifo, uint32_t* buffer, uint32_t size)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(fifo && buffer && size >= 2 * REC_FIFO_HEADER_SIZE && 0 == (size & 3))
+    {
+        fifo->buffer = buffer;
+        fifo->size = size;
+        fifo->head = 0;
+        fifo->tail = 0;
+        fifo->reserved = REC_FIFO_NO_RECORD;
+        fifo->reservedLength = 0;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets a contiguous and word aligned place for a record to fill it in place,
+ * the record is added by RecFifo_Commit (producer only)
+ * 
+ * @param fifo The record FIFO
+ * @param length The most bytes the record can have
+ * @param ptr A place to return the pointer to the record in
+ * @return Std_ReturnType A status
+ *              E_OK            If the place was reserved
+ *              E_NOT_OK        If the record FIFO does not have space for the record
+ */
+Std_ReturnType RecFifo_Reserve(recFifo_t* fifo, uint16_t length, uint8_t** ptr)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t head = fifo->head;
+    uint32_t tail = fifo->tail;
+    uint32_t need = REC_FIFO_RECORD_SIZE(length);
+    uint32_t start = REC_FIFO_NO_RECORD;
+    /* The head never catches up with the tail, equal offsets mean an empty record FIFO */
+    if(head >= tail)
+    {
+        if(need < fifo->size - head || (need == fifo->size - head && 0 != tail))
+        {
+            start = head;
+        }
+        else if(need < tail)
+        {
+            /* The end of the storage is padded so the record stays in one piece */
+            start = 0;
+        }
+    }
+    else if(need < tail - head)
+    {
+        start = head;
+    }
+    if(REC_FIFO_NO_RECORD != start)
+    {
+        fifo->reserved = start;
+        fifo->reservedLength = length;
+        *ptr = (uint8_t*)&fifo->buffer[(start + REC_FIFO_HEADER_SIZE) >> 2];
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Adds the record filled in the place given by RecFifo_Reserve (producer only)
+ * 
+ * @param fifo The record FIFO
+ * @param length The length of the record, not more than the reserved length
+ * @return Std_ReturnType A status
+ *              E_OK            If the record was added successfully
+ *              E_NOT_OK        If the length is more than the reserved length
+ */
+Std_ReturnType RecFifo_Commit(recFifo_t* fifo, uint16_t length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t head = fifo->head;
+    uint32_t start = fifo->reserved;
+    if(REC_FIFO_NO_RECORD != start && length <= fifo->reservedLength)
+    {
+        if(start != head)
+        {
+            fifo->buffer[head >> 2] = REC_FIFO_PAD;
+        }
+        fifo->buffer[start >> 2] = length;
+        /* The record must be in place before the consumer can see it */
+        REC_FIFO_BARRIER();
+        fifo->head = RecFifo_Next(fifo, start, length);
+        fifo->reserved = REC_FIFO_NO_RECORD;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Copies a record in the record FIFO (producer only)
+ * 
+ * @param fifo The record FIFO
+ * @param data The bytes of the record
+ * @param length The length of the record
+ * @return Std_ReturnType A status
+ *              E_OK            If the record was added successfully
+ *              E_NOT_OK        If the record FIFO does not have space for the record
+ */
+Std_ReturnType RecFifo_Write(recFifo_t* fifo, const uint8_t* data, uint16_t length)
+{
+    Std_ReturnType error;
+    uint8_t* ptr;
+    uint16_t i;
+    error = RecFifo_Reserve(fifo, length, &ptr);
+    if(E_OK == error)
+    {
+        for(i=0; i<length; i++)
+        {
+            ptr[i] = data[i];
+        }
+        error = RecFifo_Commit(fifo, length);
+    }
+    return error;
+}
+
+/**
+ * @brief Gets a pointer to the first record to use it in place,
+ * the record is removed by RecFifo_Release (consumer only)
+ * 
+ * @param fifo The record FIFO
+ * @param ptr A place to return the pointer to the record in
+ * @param length A place to return the length of the record in
+ * @return Std_ReturnType A status
+ *              E_OK            If a record was found
+ *              E_NOT_OK        If the record FIFO is empty
+ */
+Std_ReturnType RecFifo_Peek(recFifo_t* fifo, uint8_t** ptr, uint16_t* length)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t tail = RecFifo_Front(fifo);
+    if(REC_FIFO_NO_RECORD != tail)
+    {
+        *length = (uint16_t)fifo->buffer[tail >> 2];
+        *ptr = (uint8_t*)&fifo->buffer[(tail + REC_FIFO_HEADER_SIZE) >> 2];
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Removes the first record (consumer only)
+ * 
+ * @param fifo The record FIFO
+ * @return Std_ReturnType A status
+ *              E_OK            If the record was removed successfully
+ *              E_NOT_OK        If the record FIFO is empty
+ */
+Std_ReturnType RecFifo_Release(recFifo_t* fifo)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t tail = RecFifo_Front(fifo);
+    if(REC_FIFO_NO_RECORD != tail)
+    {
+        /* The record must be used before the producer can write over it */
+        REC_FIFO_BARRIER();
+        fifo->tail = RecFifo_Next(fifo, tail, fifo->buffer[tail >> 2]);
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Copies the first record and removes it (consumer only)
+ * 
+ * @param fifo The record FIFO
+ * @param data A buffer to copy the record in
+ * @param maxLength The size of the buffer
+ * @param length A place to return the length of the record in
+ * @return Std_ReturnType A status
+ *              E_OK            If the record was read successfully
+ *              E_NOT_OK        If the record FIFO is empty or the record is longer than the buffer,
+ *                              a longer record stays in the record FIFO and its length is returned
+ */
+Std_ReturnType RecFifo_Read(recFifo_t* fifo, uint8_t* data, uint16_t maxLength, uint16_t* length)
+{
+    Std_ReturnType error;
+    uint8_t* ptr;
+    uint16_t i;
+    error = RecFifo_Peek(fifo, &ptr, length);
+    if(E_OK == error)
+    {
+        if(*length <= maxLength)
+        {
+            for(i=0; i<*length; i++)
+            {
+                data[i] = ptr[i];
+            }
+            error = RecFifo_Release(fifo);
+        }
+        else
+        {
+            error = E_NOT_OK;
+        }
+    }
+    return error;
+}
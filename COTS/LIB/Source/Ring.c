@@ -0,0 +1,131 @@
+/**
+ * @file Ring.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the single producer single consumer ring buffer
+ * @version 0.1
+ * @date 2020-04-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "Ring.h"
+
+#define RING_MAX_SIZE                   0x80000000
+
+/**
+ * @brief Initializes a ring buffer on a storage
+ * 
+ * @param ring The ring buffer
+ * @param buffer The storage of the ring buffer
+ * @param size The size of the storage in bytes (a power of two)
+ * @return Std_ReturnType A status
+ *              E_OK            If the ring buffer was initialized successfully
+ *              E_NOT_OK        If the size is not a power of two
+ */
+Std_ReturnType Ring_Init(ring_t* ring, uint8_t* buffer, uint32_t size)
+{
+    Std_ReturnType error = E_NOT_OK;
+    /* The indexes are masked instead of wrapped so the size must be a power of two */
+    if(ring && buffer && size && size <= RING_MAX_SIZE && 0 == (size & (size - 1)))
+    {
+        ring->buffer = buffer;
+        ring->mask = size - 1;
+        ring->head = 0;
+        ring->tail = 0;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Writes as many bytes as there is space for (producer only)
+ * 
+ * @param ring The ring buffer
+ * @param data The bytes to write
+ * @param length The number of bytes to write
+ * @param written A place to return the number of bytes written in (can be NULL)
+ * @return Std_ReturnType A status
+ *              E_OK            If all the bytes were written
+ *              E_NOT_OK        If the ring buffer did not have space for all of them
+ */
+Std_ReturnType Ring_Write(ring_t* ring, const uint8_t* data, uint32_t length, uint32_t* written)
+{
+    Std_ReturnType error = E_OK;
+    uint32_t head = ring->head;
+    uint32_t space = ring->mask + 1 - (head - ring->tail);
+    uint32_t first;
+    uint32_t i;
+    if(length > space)
+    {
+        length = space;
+        error = E_NOT_OK;
+    }
+    /* The bytes up to the end of the storage then the rest from its start */
+    first = ring->mask + 1 - (head & ring->mask);
+    if(first > length)
+    {
+        first = length;
+    }
+    for(i=0; i<first; i++)
+    {
+        ring->buffer[(head & ring->mask) + i] = data[i];
+    }
+    for(; i<length; i++)
+    {
+        ring->buffer[i - first] = data[i];
+    }
+    RING_BARRIER();
+    ring->head = head + length;
+    if(written)
+    {
+        *written = length;
+    }
+    return error;
+}
+
+/**
+ * @brief Reads as many bytes as there are up to a length (consumer only)
+ * 
+ * @param ring The ring buffer
+ * @param data A buffer to read the bytes in
+ * @param length The number of bytes to read
+ * @param read A place to return the number of bytes read in (can be NULL)
+ * @return Std_ReturnType A status
+ *              E_OK            If all the bytes were read
+ *              E_NOT_OK        If the ring buffer had less bytes
+ */
+Std_ReturnType Ring_Read(ring_t* ring, uint8_t* data, uint32_t length, uint32_t* read)
+{
+    Std_ReturnType error = E_OK;
+    uint32_t tail = ring->tail;
+    uint32_t count = ring->head - tail;
+    uint32_t first;
+    uint32_t i;
+    if(length > count)
+    {
+        length = count;
+        error = E_NOT_OK;
+    }
+    /* The bytes up to the end of the storage then the rest from its start */
+    first = ring->mask + 1 - (tail & ring->mask);
+    if(first > length)
+    {
+        first = length;
+    }
+    for(i=0; i<first; i++)
+    {
+        data[i] = ring->buffer[(tail & ring->mask) + i];
+    }
+    for(; i<length; i++)
+    {
+        data[i] = ring->buffer[i - first];
+    }
+    RING_BARRIER();
+    ring->tail = tail + length;
+    if(read)
+    {
+        *read = length;
+    }
+    return error;
+}
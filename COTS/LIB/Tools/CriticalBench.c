@@ -0,0 +1,364 @@
+/**
+ * @file CriticalBench.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This file is a host benchmark of the critical sections of the LIB containers, it runs the
+ *        real Queue and Pool sources built with CRITICAL_TRACE so every section calls back here,
+ *        and prints how many sections an operation takes and how long they hold off the interrupts
+ *
+ *        Build : gcc -O2 -DCRITICAL_TRACE -I../Header -o CriticalBench CriticalBench.c ../Source/Queue.c
+ *                ../Source/Pool.c ../Source/Pool_Cfg.c ../Source/Alloc.c ../Source/Alloc_Cfg.c
+ *        Usage : CriticalBench [threshold]
+ *
+ *        Every output line is "<operation> <ns per op> <sections per op> <mean window> <max window>",
+ *        the windows are the time between the enter and the exit of the outer section minus the same
+ *        for an empty section, in time stamp counter ticks on x86 and in ns elsewhere (the max window
+ *        also holds the interrupts and the preemptions of the host, the mean is the figure to watch).
+ *        Given a threshold it fails when a mean window is longer.
+ *        On the target a section adds MRS and MSR BASEPRI_MAX (or MRS and CPSID) at the enter
+ *        and one MSR at the exit, the host only measures what the sections hold
+ * @version 0.1
+ * @date 2020-04-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Std_Types.h"
+#include "Critical_Cfg.h"
+#include "Critical.h"
+#include "Alloc.h"
+#include "Pool_Cfg.h"
+#include "Pool.h"
+#include "Queue.h"
+
+#ifndef CRITICAL_TRACE
+#error "Build the benchmark and the sources with -DCRITICAL_TRACE"
+#endif
+
+#define CRITICAL_BENCH_ELEMENTS          32              /* The elements of the queue */
+#define CRITICAL_BENCH_ELEMENT_SIZE      4
+#define CRITICAL_BENCH_CHUNK             16              /* The elements of a bulk call */
+#define CRITICAL_BENCH_BLOCK_SIZE        16              /* The size of a pool block */
+#define CRITICAL_BENCH_BLOCKS            16              /* The blocks of the smallest class in Pool_Cfg.c */
+#define CRITICAL_BENCH_ROUNDS            20000           /* The fill and drain rounds of a measure */
+#define CRITICAL_BENCH_RUNS              5               /* The best run of those is kept */
+
+#define CRITICAL_BENCH_OP_ENQUEUE        0
+#define CRITICAL_BENCH_OP_DEQUEUE        1
+#define CRITICAL_BENCH_OP_ENQUEUE_N      2
+#define CRITICAL_BENCH_OP_DEQUEUE_N      3
+#define CRITICAL_BENCH_OP_COMMIT_BACK    4
+#define CRITICAL_BENCH_OP_RELEASE_FRONT  5
+#define CRITICAL_BENCH_OP_POOL           6
+#define CRITICAL_BENCH_NUMBER_OF_OPS     7
+
+static const char* const CriticalBench_opName[CRITICAL_BENCH_NUMBER_OF_OPS] =
+{
+    "queue_enqueue",
+    "queue_dequeue",
+    "queue_enqueue_n_16",
+    "queue_dequeue_n_16",
+    "queue_commit_back",
+    "queue_release_front",
+    "pool_alloc_free"
+};
+
+static uint32_t CriticalBench_queueStorage[QUEUE_STORAGE_WORDS(CRITICAL_BENCH_ELEMENT_SIZE, CRITICAL_BENCH_ELEMENTS)];
+static uint8_t CriticalBench_element[CRITICAL_BENCH_ELEMENTS * CRITICAL_BENCH_ELEMENT_SIZE];
+static void* CriticalBench_block[CRITICAL_BENCH_BLOCKS];
+
+/* The state of the trace, only the outer one of nested sections is timed */
+static uint8_t CriticalBench_tracing;
+static uint32_t CriticalBench_depth;
+static unsigned long long CriticalBench_enterTime;
+static unsigned long long CriticalBench_sections;
+static unsigned long long CriticalBench_windowSum;
+static unsigned long long CriticalBench_windowMax;
+
+/**
+ * @brief Reads the finest clock of the host
+ *
+ * @return unsigned long long The time stamp counter on x86, else the time in nano seconds
+ */
+static inline unsigned long long CriticalBench_Stamp(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+#endif
+}
+
+/**
+ * @brief Gets the time in nano seconds
+ *
+ * @return unsigned long long The time
+ */
+static unsigned long long CriticalBench_Now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+/**
+ * @brief Called by Critical_Enter and CRITICAL_SAVE_AND_DISABLE_INTERRUPTS
+ *
+ */
+void Critical_TraceEnter(void)
+{
+    if(CriticalBench_tracing && 0 == CriticalBench_depth++)
+    {
+        CriticalBench_enterTime = CriticalBench_Stamp();
+    }
+}
+
+/**
+ * @brief Called by Critical_Exit and CRITICAL_RESTORE_INTERRUPTS
+ *
+ */
+void Critical_TraceExit(void)
+{
+    unsigned long long window;
+    if(CriticalBench_tracing && 0 == --CriticalBench_depth)
+    {
+        window = CriticalBench_Stamp() - CriticalBench_enterTime;
+        CriticalBench_sections++;
+        CriticalBench_windowSum += window;
+        if(window > CriticalBench_windowMax)
+        {
+            CriticalBench_windowMax = window;
+        }
+    }
+}
+
+/**
+ * @brief Runs an operation over the whole queue or pool, they are filled or drained around
+ *        the operation so only it is measured
+ *
+ * @param op The operation
+ * @param queue The queue
+ */
+static void CriticalBench_Round(uint8_t op, queue_t* queue)
+{
+    uint8_t* ptr;
+    uint16_t moved;
+    uint16_t i;
+    switch(op)
+    {
+        case CRITICAL_BENCH_OP_ENQUEUE:
+            for(i=0; i<CRITICAL_BENCH_ELEMENTS; i++)
+            {
+                Queue_Enqueue(queue, CriticalBench_element);
+            }
+            break;
+        case CRITICAL_BENCH_OP_DEQUEUE:
+            for(i=0; i<CRITICAL_BENCH_ELEMENTS; i++)
+            {
+                Queue_Dequeue(queue, CriticalBench_element);
+            }
+            break;
+        case CRITICAL_BENCH_OP_ENQUEUE_N:
+            for(i=0; i<CRITICAL_BENCH_ELEMENTS; i+=CRITICAL_BENCH_CHUNK)
+            {
+                Queue_EnqueueN(queue, CriticalBench_element, CRITICAL_BENCH_CHUNK, &moved);
+            }
+            break;
+        case CRITICAL_BENCH_OP_DEQUEUE_N:
+            for(i=0; i<CRITICAL_BENCH_ELEMENTS; i+=CRITICAL_BENCH_CHUNK)
+            {
+                Queue_DequeueN(queue, CriticalBench_element, CRITICAL_BENCH_CHUNK, &moved);
+            }
+            break;
+        case CRITICAL_BENCH_OP_COMMIT_BACK:
+            for(i=0; i<CRITICAL_BENCH_ELEMENTS; i++)
+            {
+                Queue_ReserveBack(queue, &ptr);
+                ptr[0] = (uint8_t)i;
+                Queue_CommitBack(queue);
+            }
+            break;
+        case CRITICAL_BENCH_OP_RELEASE_FRONT:
+            for(i=0; i<CRITICAL_BENCH_ELEMENTS; i++)
+            {
+                Queue_PeekFront(queue, &ptr);
+                CriticalBench_element[0] = ptr[0];
+                Queue_ReleaseFront(queue);
+            }
+            break;
+        default:
+            for(i=0; i<CRITICAL_BENCH_BLOCKS; i++)
+            {
+                Pool_Alloc(&CriticalBench_block[i], CRITICAL_BENCH_BLOCK_SIZE);
+            }
+            for(i=0; i<CRITICAL_BENCH_BLOCKS; i++)
+            {
+                Pool_Free(CriticalBench_block[i]);
+            }
+            break;
+    }
+}
+
+/**
+ * @brief Gets the window of a section that holds nothing, it is the cost of the trace itself
+ *
+ * @return unsigned long long The shortest empty window
+ */
+static unsigned long long CriticalBench_EmptyWindow(void)
+{
+    unsigned long long best = (unsigned long long)-1;
+    uint32_t state;
+    unsigned long round;
+    CriticalBench_tracing = 1;
+    for(round=0; round<CRITICAL_BENCH_ROUNDS; round++)
+    {
+        CriticalBench_windowMax = 0;
+        state = Critical_Enter();
+        Critical_Exit(state);
+        if(CriticalBench_windowMax < best)
+        {
+            best = CriticalBench_windowMax;
+        }
+    }
+    CriticalBench_tracing = 0;
+    return best;
+}
+
+/**
+ * @brief Measures an operation
+ *
+ * @param op The operation
+ * @param emptyWindow The window of an empty section
+ * @param nsPerOp A place to return the time per operation in
+ * @param sectionsPerOp A place to return the sections per operation in
+ * @param meanWindow A place to return the mean window in
+ * @param maxWindow A place to return the longest window in
+ * @return int 0 if the containers could be created
+ */
+static int CriticalBench_Measure(uint8_t op, unsigned long long emptyWindow, double* nsPerOp,
+                                 double* sectionsPerOp, double* meanWindow, double* maxWindow)
+{
+    queue_t queue;
+    unsigned long long start;
+    unsigned long long elapsed;
+    unsigned long long bestTime = (unsigned long long)-1;
+    double bestMean = -1;
+    double operations = (double)CRITICAL_BENCH_ROUNDS * CRITICAL_BENCH_ELEMENTS;
+    unsigned long round;
+    uint8_t tracing;
+    int run;
+    uint16_t i;
+    if(E_OK != Queue_CreateStatic(&queue, CriticalBench_queueStorage, sizeof(CriticalBench_queueStorage),
+                                  CRITICAL_BENCH_ELEMENT_SIZE, CRITICAL_BENCH_ELEMENTS))
+    {
+        return 1;
+    }
+    if(CRITICAL_BENCH_OP_ENQUEUE_N == op || CRITICAL_BENCH_OP_DEQUEUE_N == op)
+    {
+        operations /= CRITICAL_BENCH_CHUNK;
+    }
+    else if(CRITICAL_BENCH_OP_POOL == op)
+    {
+        operations = (double)CRITICAL_BENCH_ROUNDS * CRITICAL_BENCH_BLOCKS;
+    }
+    *maxWindow = 0;
+    for(run=0; run<CRITICAL_BENCH_RUNS; run++)
+    {
+        /* The time is taken without the windows so the stamps do not add to it */
+        for(tracing=0; tracing<2; tracing++)
+        {
+            CriticalBench_sections = 0;
+            CriticalBench_windowSum = 0;
+            CriticalBench_windowMax = 0;
+            elapsed = 0;
+            for(round=0; round<CRITICAL_BENCH_ROUNDS; round++)
+            {
+                /* The dequeue and release run on a full queue, the others on an empty one */
+                if(CRITICAL_BENCH_OP_DEQUEUE == op || CRITICAL_BENCH_OP_DEQUEUE_N == op || CRITICAL_BENCH_OP_RELEASE_FRONT == op)
+                {
+                    for(i=0; i<CRITICAL_BENCH_ELEMENTS; i++)
+                    {
+                        Queue_Enqueue(&queue, CriticalBench_element);
+                    }
+                }
+                CriticalBench_tracing = tracing;
+                start = CriticalBench_Now();
+                CriticalBench_Round(op, &queue);
+                elapsed += CriticalBench_Now() - start;
+                CriticalBench_tracing = 0;
+                while(E_OK == Queue_Dequeue(&queue, CriticalBench_element))
+                {
+                }
+            }
+            if(0 == tracing && elapsed < bestTime)
+            {
+                bestTime = elapsed;
+            }
+        }
+        if(0 == CriticalBench_sections)
+        {
+            bestMean = 0;
+            *maxWindow = 0;
+        }
+        else if(bestMean < 0 || (double)CriticalBench_windowSum / (double)CriticalBench_sections < bestMean)
+        {
+            bestMean = (double)CriticalBench_windowSum / (double)CriticalBench_sections;
+            *maxWindow = (double)CriticalBench_windowMax;
+        }
+        *sectionsPerOp = (double)CriticalBench_sections / operations;
+    }
+    *nsPerOp = (double)bestTime / operations;
+    *meanWindow = (bestMean > (double)emptyWindow) ? bestMean - (double)emptyWindow : 0;
+    *maxWindow = (*maxWindow > (double)emptyWindow) ? *maxWindow - (double)emptyWindow : 0;
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned long long emptyWindow;
+    double threshold = -1;
+    double nsPerOp;
+    double sectionsPerOp;
+    double meanWindow;
+    double maxWindow;
+    int overThreshold = 0;
+    uint8_t op;
+
+    if(argc > 2 || (argc == 2 && (threshold = strtod(argv[1], NULL)) <= 0))
+    {
+        fprintf(stderr, "Usage : %s [threshold]\n", argv[0]);
+        return 1;
+    }
+    if(E_OK != Pool_Init())
+    {
+        fprintf(stderr, "Can not create the pool\n");
+        return 1;
+    }
+
+    emptyWindow = CriticalBench_EmptyWindow();
+#if defined(__x86_64__) || defined(__i386__)
+    printf("# windows in time stamp counter ticks, an empty section is %llu\n", emptyWindow);
+#else
+    printf("# windows in ns, an empty section is %llu\n", emptyWindow);
+#endif
+    for(op=0; op<CRITICAL_BENCH_NUMBER_OF_OPS; op++)
+    {
+        if(CriticalBench_Measure(op, emptyWindow, &nsPerOp, &sectionsPerOp, &meanWindow, &maxWindow))
+        {
+            fprintf(stderr, "Can not create the queue\n");
+            return 1;
+        }
+        printf("%-20s %8.2f %6.2f %8.1f %8.0f\n", CriticalBench_opName[op], nsPerOp, sectionsPerOp, meanWindow, maxWindow);
+        if(threshold > 0 && meanWindow > threshold)
+        {
+            fprintf(stderr, "%s holds the interrupts off for %.1f, over %.1f\n", CriticalBench_opName[op], meanWindow, threshold);
+            overThreshold++;
+        }
+    }
+    return (overThreshold > 0) ? 2 : 0;
+}
@@ -0,0 +1,378 @@
+/**
+ * @file LibBench.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This file is a host micro benchmark of the LIB containers, it runs the real Queue,
+ *        Alloc and Arena sources and prints the cost of every operation per element size,
+ *        given a baseline it fails when an operation got slower than a threshold
+ *
+ *        Build : gcc -O2 -I../Header -o LibBench LibBench.c ../Source/Queue.c ../Source/Alloc.c
+ *                ../Source/Alloc_Cfg.c ../Source/Arena.c
+ *        Usage : LibBench > baseline.txt
+ *                LibBench baseline.txt [threshold in %]
+ *
+ *        Every output line is "<operation> <element size> <ns per op> <instructions per op>",
+ *        the instructions are counted on Linux when the perf events are allowed, else they are 0
+ * @version 0.1
+ * @date 2020-04-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "Std_Types.h"
+#include "Alloc.h"
+#include "Arena.h"
+#include "Queue.h"
+
+#define LIB_BENCH_ELEMENTS               32              /* The elements of every queue */
+#define LIB_BENCH_MAX_ELEMENT_SIZE       64
+#define LIB_BENCH_ROUNDS                 20000           /* The fill and drain rounds of a measure */
+#define LIB_BENCH_RUNS                   5               /* The best run of those is kept */
+#define LIB_BENCH_ARENA_SIZE             4096
+#define LIB_BENCH_DEFAULT_THRESHOLD      10.0            /* The allowed slow down in % */
+#define LIB_BENCH_MAX_RESULTS            64
+#define LIB_BENCH_MAX_NAME               32
+#define LIB_BENCH_MAX_LINE               128
+
+#define LIB_BENCH_OP_ENQUEUE             0
+#define LIB_BENCH_OP_DEQUEUE             1
+#define LIB_BENCH_OP_PEEK                2
+#define LIB_BENCH_OP_IS_FULL             3
+#define LIB_BENCH_OP_IS_EMPTY            4
+#define LIB_BENCH_OP_ALLOC               5
+#define LIB_BENCH_NUMBER_OF_OPS          6
+
+static const char* const LibBench_opName[LIB_BENCH_NUMBER_OF_OPS] =
+{
+    "queue_enqueue",
+    "queue_dequeue",
+    "queue_peek",
+    "queue_is_full",
+    "queue_is_empty",
+    "arena_alloc"
+};
+
+static const uint16_t LibBench_elementSize[] = {1, 4, 12, 64};
+
+#define LIB_BENCH_NUMBER_OF_SIZES        (sizeof(LibBench_elementSize) / sizeof(LibBench_elementSize[0]))
+
+/**
+ * @brief The cost of an operation at an element size
+ *
+ */
+typedef struct
+{
+    char name[LIB_BENCH_MAX_NAME];
+    unsigned long elementSize;
+    double nsPerOp;
+    double instructionsPerOp;
+} libBenchResult_t;
+
+static uint32_t LibBench_queueStorage[QUEUE_STORAGE_WORDS(LIB_BENCH_MAX_ELEMENT_SIZE, LIB_BENCH_ELEMENTS)];
+static uint32_t LibBench_arenaStorage[LIB_BENCH_ARENA_SIZE / sizeof(uint32_t)];
+static uint8_t LibBench_element[LIB_BENCH_MAX_ELEMENT_SIZE];
+static volatile uint32_t LibBench_sink;
+static int LibBench_counter = -1;
+
+/**
+ * @brief Opens the instruction counter of this thread if the system allows it
+ *
+ */
+static void LibBench_OpenCounter(void)
+{
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    LibBench_counter = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+/**
+ * @brief Starts counting the instructions
+ *
+ */
+static void LibBench_StartCounter(void)
+{
+#ifdef __linux__
+    if(LibBench_counter >= 0)
+    {
+        ioctl(LibBench_counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(LibBench_counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+/**
+ * @brief Stops counting the instructions
+ *
+ * @return unsigned long long The instructions since the start, 0 without a counter
+ */
+static unsigned long long LibBench_StopCounter(void)
+{
+    unsigned long long count = 0;
+#ifdef __linux__
+    if(LibBench_counter >= 0)
+    {
+        ioctl(LibBench_counter, PERF_EVENT_IOC_DISABLE, 0);
+        if(sizeof(count) != read(LibBench_counter, &count, sizeof(count)))
+        {
+            count = 0;
+        }
+    }
+#endif
+    return count;
+}
+
+/**
+ * @brief Gets the time in nano seconds
+ *
+ * @return unsigned long long The time
+ */
+static unsigned long long LibBench_Now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+/**
+ * @brief Runs an operation over a full queue or an empty one, the queue is filled or drained
+ *        around the timed part so only the operation is measured
+ *
+ * @param op The operation
+ * @param queue The queue
+ * @param arena The arena
+ * @param elementSize The element size in bytes
+ */
+static void LibBench_Round(uint8_t op, queue_t* queue, arena_t* arena, uint16_t elementSize)
+{
+    uint8_t* ptr;
+    void* block;
+    uint8_t state;
+    arenaMark_t mark;
+    uint16_t i;
+    switch(op)
+    {
+        case LIB_BENCH_OP_ENQUEUE:
+            for(i=0; i<LIB_BENCH_ELEMENTS; i++)
+            {
+                Queue_Enqueue(queue, LibBench_element);
+            }
+            break;
+        case LIB_BENCH_OP_DEQUEUE:
+            for(i=0; i<LIB_BENCH_ELEMENTS; i++)
+            {
+                Queue_Dequeue(queue, LibBench_element);
+            }
+            break;
+        case LIB_BENCH_OP_PEEK:
+            for(i=0; i<LIB_BENCH_ELEMENTS; i++)
+            {
+                Queue_PeekFront(queue, &ptr);
+                LibBench_sink += ptr[0];
+            }
+            break;
+        case LIB_BENCH_OP_IS_FULL:
+            for(i=0; i<LIB_BENCH_ELEMENTS; i++)
+            {
+                Queue_IsFull(queue, &state);
+                LibBench_sink += state;
+            }
+            break;
+        case LIB_BENCH_OP_IS_EMPTY:
+            for(i=0; i<LIB_BENCH_ELEMENTS; i++)
+            {
+                Queue_IsEmpty(queue, &state);
+                LibBench_sink += state;
+            }
+            break;
+        default:
+            Arena_Mark(arena, &mark);
+            for(i=0; i<LIB_BENCH_ELEMENTS; i++)
+            {
+                Arena_Alloc(arena, &block, elementSize);
+                LibBench_sink += (uint32_t)(unsigned long)block;
+            }
+            Arena_Release(arena, mark);
+            break;
+    }
+}
+
+/**
+ * @brief Measures an operation at an element size
+ *
+ * @param op The operation
+ * @param elementSize The element size in bytes
+ * @param result A place to return the cost in
+ * @return int 0 if the containers could be created
+ */
+static int LibBench_Measure(uint8_t op, uint16_t elementSize, libBenchResult_t* result)
+{
+    queue_t queue;
+    arena_t arena;
+    unsigned long long start;
+    unsigned long long elapsed;
+    unsigned long long instructions;
+    unsigned long long bestTime = (unsigned long long)-1;
+    unsigned long long bestInstructions = (unsigned long long)-1;
+    unsigned long round;
+    int run;
+    uint16_t i;
+    if(E_OK != Queue_CreateStatic(&queue, LibBench_queueStorage, sizeof(LibBench_queueStorage), elementSize, LIB_BENCH_ELEMENTS) ||
+       E_OK != Arena_Init(&arena, (uint8_t*)LibBench_arenaStorage, LIB_BENCH_ARENA_SIZE))
+    {
+        return 1;
+    }
+    for(run=0; run<LIB_BENCH_RUNS; run++)
+    {
+        elapsed = 0;
+        instructions = 0;
+        for(round=0; round<LIB_BENCH_ROUNDS; round++)
+        {
+            /* The dequeue and peek run on a full queue, the enqueue and the checks on an empty one */
+            if(LIB_BENCH_OP_DEQUEUE == op || LIB_BENCH_OP_PEEK == op || LIB_BENCH_OP_IS_FULL == op)
+            {
+                for(i=0; i<LIB_BENCH_ELEMENTS; i++)
+                {
+                    Queue_Enqueue(&queue, LibBench_element);
+                }
+            }
+            LibBench_StartCounter();
+            start = LibBench_Now();
+            LibBench_Round(op, &queue, &arena, elementSize);
+            elapsed += LibBench_Now() - start;
+            instructions += LibBench_StopCounter();
+            while(E_OK == Queue_Dequeue(&queue, LibBench_element))
+            {
+            }
+        }
+        if(elapsed < bestTime)
+        {
+            bestTime = elapsed;
+        }
+        if(instructions < bestInstructions)
+        {
+            bestInstructions = instructions;
+        }
+    }
+    strcpy(result->name, LibBench_opName[op]);
+    result->elementSize = elementSize;
+    result->nsPerOp = (double)bestTime / ((double)LIB_BENCH_ROUNDS * LIB_BENCH_ELEMENTS);
+    result->instructionsPerOp = (double)bestInstructions / ((double)LIB_BENCH_ROUNDS * LIB_BENCH_ELEMENTS);
+    return 0;
+}
+
+/**
+ * @brief Reads the results of an earlier run
+ *
+ * @param fileName The file of the results
+ * @param results An array to read the results in
+ * @return int The number of results, -1 if the file could not be opened
+ */
+static int LibBench_ReadBaseline(const char* fileName, libBenchResult_t* results)
+{
+    char line[LIB_BENCH_MAX_LINE];
+    FILE* file = fopen(fileName, "r");
+    int count = 0;
+    if(NULL == file)
+    {
+        return -1;
+    }
+    while(count < LIB_BENCH_MAX_RESULTS && fgets(line, sizeof(line), file))
+    {
+        if(4 == sscanf(line, "%31s %lu %lf %lf", results[count].name, &results[count].elementSize,
+                       &results[count].nsPerOp, &results[count].instructionsPerOp))
+        {
+            count++;
+        }
+    }
+    fclose(file);
+    return count;
+}
+
+int main(int argc, char* argv[])
+{
+    libBenchResult_t results[LIB_BENCH_MAX_RESULTS];
+    libBenchResult_t baseline[LIB_BENCH_MAX_RESULTS];
+    int numberOfResults = 0;
+    int numberOfBaseline = 0;
+    int regressions = 0;
+    double threshold = LIB_BENCH_DEFAULT_THRESHOLD;
+    double change;
+    uint8_t op;
+    unsigned long size;
+    int i;
+    int j;
+
+    if(argc > 3 || (argc == 3 && (threshold = strtod(argv[2], NULL)) <= 0))
+    {
+        fprintf(stderr, "Usage : %s [baseline.txt [threshold in %%]]\n", argv[0]);
+        return 1;
+    }
+    if(argc >= 2 && (numberOfBaseline = LibBench_ReadBaseline(argv[1], baseline)) < 0)
+    {
+        fprintf(stderr, "Can not read %s\n", argv[1]);
+        return 1;
+    }
+
+    LibBench_OpenCounter();
+    for(op=0; op<LIB_BENCH_NUMBER_OF_OPS; op++)
+    {
+        for(size=0; size<LIB_BENCH_NUMBER_OF_SIZES; size++)
+        {
+            if(LibBench_Measure(op, LibBench_elementSize[size], &results[numberOfResults]))
+            {
+                fprintf(stderr, "Can not create the containers\n");
+                return 1;
+            }
+            printf("%-16s %4lu %10.2f %10.1f\n", results[numberOfResults].name, results[numberOfResults].elementSize,
+                   results[numberOfResults].nsPerOp, results[numberOfResults].instructionsPerOp);
+            numberOfResults++;
+        }
+    }
+
+    /* The instructions are steadier than the time so they are compared when both runs have them */
+    for(i=0; i<numberOfResults; i++)
+    {
+        for(j=0; j<numberOfBaseline; j++)
+        {
+            if(0 == strcmp(results[i].name, baseline[j].name) && results[i].elementSize == baseline[j].elementSize)
+            {
+                if(results[i].instructionsPerOp > 0 && baseline[j].instructionsPerOp > 0)
+                {
+                    change = (results[i].instructionsPerOp / baseline[j].instructionsPerOp - 1.0) * 100.0;
+                }
+                else
+                {
+                    change = (results[i].nsPerOp / baseline[j].nsPerOp - 1.0) * 100.0;
+                }
+                if(change > threshold)
+                {
+                    fprintf(stderr, "%s %lu is %.1f %% slower than the baseline\n", results[i].name, results[i].elementSize, change);
+                    regressions++;
+                }
+            }
+        }
+    }
+    if(numberOfBaseline > 0)
+    {
+        fprintf(stderr, "%d regressions over %.1f %%\n", regressions, threshold);
+    }
+    return (regressions > 0) ? 2 : 0;
+}
@@ -0,0 +1,427 @@
+/**
+ * @file RingStress.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This file is a host stress test and benchmark of the Ring buffer, a producer thread
+ *        and a consumer thread run the real Ring source like an interrupt and a task would,
+ *        then the cost of moving a byte through the Ring and through the Queue is compared
+ *
+ *        Build : gcc -O2 -pthread -I../Header -o RingStress RingStress.c ../Source/Ring.c
+ *                ../Source/Queue.c ../Source/Alloc.c ../Source/Alloc_Cfg.c
+ *        Usage : RingStress [bytes]
+ *
+ *        The stress fails when a byte is lost, repeated or out of order, or when the count
+ *        goes over the size of the ring. Every benchmark line is
+ *        "<operation> <ns per byte> <cycles per byte>", the cycles are counted on Linux when
+ *        the perf events are allowed, else they are 0.
+ *        RING_BARRIER only keeps the compiler in order, that is all the single core target needs,
+ *        so on a host that is not x86 (not strongly ordered) both threads share one CPU
+ * @version 0.1
+ * @date 2020-04-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#include "Std_Types.h"
+#include "Ring.h"
+#include "Queue.h"
+
+#define RING_STRESS_SIZE                 64              /* The bytes of the ring, small so it is full and empty often */
+#define RING_STRESS_DEFAULT_BYTES        100000000UL
+#define RING_STRESS_MAX_CHUNK            37              /* The longest Ring_Write and Ring_Read */
+#define RING_STRESS_BENCH_ELEMENTS       32              /* The bytes of a fill and drain round */
+#define RING_STRESS_BENCH_CHUNK          16              /* The bytes of a bulk call */
+#define RING_STRESS_BENCH_ROUNDS         100000
+#define RING_STRESS_BENCH_RUNS           5               /* The best run of those is kept */
+
+#define RING_STRESS_OP_RING_PUT_GET      0
+#define RING_STRESS_OP_QUEUE_BYTE        1
+#define RING_STRESS_OP_RING_WRITE_READ   2
+#define RING_STRESS_OP_QUEUE_N           3
+#define RING_STRESS_NUMBER_OF_OPS        4
+
+static const char* const RingStress_opName[RING_STRESS_NUMBER_OF_OPS] =
+{
+    "ring_put_get",
+    "queue_enqueue_dequeue",
+    "ring_write_read_16",
+    "queue_enqueue_dequeue_n_16"
+};
+
+static uint8_t RingStress_storage[RING_STRESS_SIZE];
+static ring_t RingStress_ring;
+static unsigned long RingStress_bytes = RING_STRESS_DEFAULT_BYTES;
+
+static uint32_t RingStress_queueStorage[QUEUE_STORAGE_WORDS(1, RING_STRESS_BENCH_ELEMENTS)];
+static uint8_t RingStress_element[RING_STRESS_BENCH_ELEMENTS];
+static volatile uint32_t RingStress_sink;
+static int RingStress_counter = -1;
+
+/**
+ * @brief The byte of a position in the stream, a lost or repeated run of 256 bytes changes it too
+ *
+ * @param position The position in the stream
+ * @return uint8_t The byte
+ */
+static uint8_t RingStress_Byte(unsigned long position)
+{
+    return (uint8_t)((position ^ (position >> 8) ^ (position >> 16)) * 0x9DUL);
+}
+
+/**
+ * @brief A simple pseudo random number for the chunk lengths
+ *
+ * @param seed The state of the generator
+ * @return uint32_t The number
+ */
+static uint32_t RingStress_Random(uint32_t* seed)
+{
+    *seed = *seed * 1103515245UL + 12345UL;
+    return *seed >> 16;
+}
+
+/**
+ * @brief The producer, it writes the stream with Ring_Put and Ring_Write of random lengths
+ *
+ * @param arg Unused
+ * @return void* NULL
+ */
+static void* RingStress_Producer(void* arg)
+{
+    uint8_t chunk[RING_STRESS_MAX_CHUNK];
+    unsigned long position = 0;
+    uint32_t seed = 1;
+    uint32_t length;
+    uint32_t written;
+    uint32_t i;
+    (void)arg;
+    while(position < RingStress_bytes)
+    {
+        length = RingStress_Random(&seed) % RING_STRESS_MAX_CHUNK;
+        if(length > RingStress_bytes - position)
+        {
+            length = (uint32_t)(RingStress_bytes - position);
+        }
+        if(0 == length)
+        {
+            if(E_OK == Ring_Put(&RingStress_ring, RingStress_Byte(position)))
+            {
+                position++;
+            }
+            else
+            {
+                sched_yield();
+            }
+        }
+        else
+        {
+            for(i=0; i<length; i++)
+            {
+                chunk[i] = RingStress_Byte(position + i);
+            }
+            Ring_Write(&RingStress_ring, chunk, length, &written);
+            position += written;
+            if(0 == written)
+            {
+                sched_yield();
+            }
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief The consumer, it reads the stream with Ring_Get and Ring_Read of random lengths
+ *        and checks every byte
+ *
+ * @param arg A place to return the number of errors in
+ * @return void* NULL
+ */
+static void* RingStress_Consumer(void* arg)
+{
+    uint8_t chunk[RING_STRESS_MAX_CHUNK];
+    unsigned long* errors = (unsigned long*)arg;
+    unsigned long position = 0;
+    uint32_t seed = 2;
+    uint32_t length;
+    uint32_t read;
+    uint32_t count;
+    uint32_t i;
+    while(position < RingStress_bytes && *errors < 10)
+    {
+        Ring_GetCount(&RingStress_ring, &count);
+        if(count > RING_STRESS_SIZE)
+        {
+            fprintf(stderr, "The ring holds %lu bytes at byte %lu\n", (unsigned long)count, position);
+            (*errors)++;
+        }
+        length = RingStress_Random(&seed) % RING_STRESS_MAX_CHUNK;
+        if(0 == length)
+        {
+            read = (E_OK == Ring_Get(&RingStress_ring, chunk)) ? 1 : 0;
+        }
+        else
+        {
+            Ring_Read(&RingStress_ring, chunk, length, &read);
+        }
+        for(i=0; i<read; i++)
+        {
+            if(RingStress_Byte(position + i) != chunk[i])
+            {
+                fprintf(stderr, "Byte %lu is 0x%02X, it should be 0x%02X\n", position + i,
+                        chunk[i], RingStress_Byte(position + i));
+                (*errors)++;
+            }
+        }
+        position += read;
+        if(0 == read)
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Opens the cycle counter of this thread if the system allows it
+ *
+ */
+static void RingStress_OpenCounter(void)
+{
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CPU_CYCLES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    RingStress_counter = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+}
+
+/**
+ * @brief Starts counting the cycles
+ *
+ */
+static void RingStress_StartCounter(void)
+{
+#ifdef __linux__
+    if(RingStress_counter >= 0)
+    {
+        ioctl(RingStress_counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(RingStress_counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#endif
+}
+
+/**
+ * @brief Stops counting the cycles
+ *
+ * @return unsigned long long The cycles since the start, 0 without a counter
+ */
+static unsigned long long RingStress_StopCounter(void)
+{
+    unsigned long long count = 0;
+#ifdef __linux__
+    if(RingStress_counter >= 0)
+    {
+        ioctl(RingStress_counter, PERF_EVENT_IOC_DISABLE, 0);
+        if(sizeof(count) != read(RingStress_counter, &count, sizeof(count)))
+        {
+            count = 0;
+        }
+    }
+#endif
+    return count;
+}
+
+/**
+ * @brief Gets the time in nano seconds
+ *
+ * @return unsigned long long The time
+ */
+static unsigned long long RingStress_Now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+/**
+ * @brief Fills and drains a container once with an operation
+ *
+ * @param op The operation
+ * @param queue The queue
+ */
+static void RingStress_Round(uint8_t op, queue_t* queue)
+{
+    uint16_t moved;
+    uint16_t i;
+    switch(op)
+    {
+        case RING_STRESS_OP_RING_PUT_GET:
+            for(i=0; i<RING_STRESS_BENCH_ELEMENTS; i++)
+            {
+                Ring_Put(&RingStress_ring, RingStress_element[i]);
+            }
+            for(i=0; i<RING_STRESS_BENCH_ELEMENTS; i++)
+            {
+                Ring_Get(&RingStress_ring, &RingStress_element[i]);
+            }
+            break;
+        case RING_STRESS_OP_QUEUE_BYTE:
+            for(i=0; i<RING_STRESS_BENCH_ELEMENTS; i++)
+            {
+                Queue_Enqueue(queue, &RingStress_element[i]);
+            }
+            for(i=0; i<RING_STRESS_BENCH_ELEMENTS; i++)
+            {
+                Queue_Dequeue(queue, &RingStress_element[i]);
+            }
+            break;
+        case RING_STRESS_OP_RING_WRITE_READ:
+            for(i=0; i<RING_STRESS_BENCH_ELEMENTS; i+=RING_STRESS_BENCH_CHUNK)
+            {
+                Ring_Write(&RingStress_ring, &RingStress_element[i], RING_STRESS_BENCH_CHUNK, NULL);
+            }
+            for(i=0; i<RING_STRESS_BENCH_ELEMENTS; i+=RING_STRESS_BENCH_CHUNK)
+            {
+                Ring_Read(&RingStress_ring, &RingStress_element[i], RING_STRESS_BENCH_CHUNK, NULL);
+            }
+            break;
+        default:
+            for(i=0; i<RING_STRESS_BENCH_ELEMENTS; i+=RING_STRESS_BENCH_CHUNK)
+            {
+                Queue_EnqueueN(queue, &RingStress_element[i], RING_STRESS_BENCH_CHUNK, &moved);
+            }
+            for(i=0; i<RING_STRESS_BENCH_ELEMENTS; i+=RING_STRESS_BENCH_CHUNK)
+            {
+                Queue_DequeueN(queue, &RingStress_element[i], RING_STRESS_BENCH_CHUNK, &moved);
+            }
+            break;
+    }
+    RingStress_sink += RingStress_element[0];
+}
+
+/**
+ * @brief Measures the cost of moving a byte with an operation
+ *
+ * @param op The operation
+ * @param nsPerByte A place to return the time per byte in
+ * @param cyclesPerByte A place to return the cycles per byte in
+ * @return int 0 if the containers could be created
+ */
+static int RingStress_Measure(uint8_t op, double* nsPerByte, double* cyclesPerByte)
+{
+    queue_t queue;
+    unsigned long long start;
+    unsigned long long elapsed;
+    unsigned long long cycles;
+    unsigned long long bestTime = (unsigned long long)-1;
+    unsigned long long bestCycles = (unsigned long long)-1;
+    unsigned long round;
+    int run;
+    if(E_OK != Ring_Init(&RingStress_ring, RingStress_storage, RING_STRESS_SIZE) ||
+       E_OK != Queue_CreateStatic(&queue, RingStress_queueStorage, sizeof(RingStress_queueStorage), 1, RING_STRESS_BENCH_ELEMENTS))
+    {
+        return 1;
+    }
+    for(run=0; run<RING_STRESS_BENCH_RUNS; run++)
+    {
+        RingStress_StartCounter();
+        start = RingStress_Now();
+        for(round=0; round<RING_STRESS_BENCH_ROUNDS; round++)
+        {
+            RingStress_Round(op, &queue);
+        }
+        elapsed = RingStress_Now() - start;
+        cycles = RingStress_StopCounter();
+        if(elapsed < bestTime)
+        {
+            bestTime = elapsed;
+        }
+        if(cycles < bestCycles)
+        {
+            bestCycles = cycles;
+        }
+    }
+    *nsPerByte = (double)bestTime / ((double)RING_STRESS_BENCH_ROUNDS * RING_STRESS_BENCH_ELEMENTS);
+    *cyclesPerByte = (double)bestCycles / ((double)RING_STRESS_BENCH_ROUNDS * RING_STRESS_BENCH_ELEMENTS);
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    pthread_t producer;
+    pthread_t consumer;
+    unsigned long errors = 0;
+    unsigned long long start;
+    double nsPerByte;
+    double cyclesPerByte;
+    uint8_t op;
+#if defined(__linux__) && !defined(__x86_64__) && !defined(__i386__)
+    cpu_set_t cpus;
+#endif
+
+    if(argc > 2 || (argc == 2 && 0 == (RingStress_bytes = strtoul(argv[1], NULL, 10))))
+    {
+        fprintf(stderr, "Usage : %s [bytes]\n", argv[0]);
+        return 1;
+    }
+
+#if defined(__linux__) && !defined(__x86_64__) && !defined(__i386__)
+    /* The threads inherit the CPU of the main thread */
+    CPU_ZERO(&cpus);
+    CPU_SET(0, &cpus);
+    sched_setaffinity(0, sizeof(cpus), &cpus);
+#endif
+    if(E_OK != Ring_Init(&RingStress_ring, RingStress_storage, RING_STRESS_SIZE))
+    {
+        fprintf(stderr, "Can not create the ring\n");
+        return 1;
+    }
+    start = RingStress_Now();
+    if(0 != pthread_create(&consumer, NULL, RingStress_Consumer, &errors) ||
+       0 != pthread_create(&producer, NULL, RingStress_Producer, NULL))
+    {
+        fprintf(stderr, "Can not create the threads\n");
+        return 1;
+    }
+    pthread_join(consumer, NULL);
+    if(0 == errors)
+    {
+        pthread_join(producer, NULL);
+    }
+    printf("stress %lu bytes through %u bytes in %.2f s, %lu errors\n", RingStress_bytes, RING_STRESS_SIZE,
+           (double)(RingStress_Now() - start) / 1e9, errors);
+    if(0 != errors)
+    {
+        return 2;
+    }
+
+    RingStress_OpenCounter();
+    for(op=0; op<RING_STRESS_NUMBER_OF_OPS; op++)
+    {
+        if(RingStress_Measure(op, &nsPerByte, &cyclesPerByte))
+        {
+            fprintf(stderr, "Can not create the containers\n");
+            return 1;
+        }
+        printf("%-28s %8.2f %8.1f\n", RingStress_opName[op], nsPerByte, cyclesPerByte);
+    }
+    return 0;
+}
@@ -185,4 +185,17 @@ extern Std_ReturnType Dma_TransferPrephData(uint8_t channelNumber, uint32_t prep
  */
 extern Std_ReturnType Dma_SetCallBack(uint8_t channelNumber, dmaCb_t callBack);
 
+/**
+ * @brief Gets The Number Of Blocks Left To Transfer On A Certain DMA Channel
+ * (in circular mode it goes back to the full count after every pass)
+ * 
+ * @param channelNumber The DMA Channel Number
+ *                  @arg DMA_CH_x
+ * @param remaining A Place To Return The Number Of Blocks In
+ * @return Std_ReturnType 
+ *                  E_OK If the function was executed successfully
+ *                  E_NOT_OK If the function was not executed successfully
+ */
+extern Std_ReturnType Dma_GetRemaining(uint8_t channelNumber, uint16_t* remaining);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,33 @@
+/**
+ * @file Dwt.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the user interface for the DWT cycle counter driver
+ * @version 0.1
+ * @date 2020-05-10
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef DWT_H
+#define DWT_H
+
+/**
+ * @brief Enables and resets the cycle counter
+ * 
+ * @return Std_ReturnType 
+ *                  E_OK If the function was executed successfully
+ *                  E_NOT_OK If the function was not executed successfully
+ */
+extern Std_ReturnType Dwt_Init(void);
+
+/**
+ * @brief Reads the cycle counter
+ * 
+ * @param cycles A pointer to return the number of core cycles in
+ * @return Std_ReturnType 
+ *                  E_OK If the function was executed successfully
+ *                  E_NOT_OK If the function was not executed successfully
+ */
+extern Std_ReturnType Dwt_GetCycles(uint32_t* cycles);
+
+#endif
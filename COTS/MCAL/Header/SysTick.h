@@ -10,6 +10,9 @@
 #ifndef SYSTICK_H
 #define SYSTICK_H
 
+#define SYSTICK_NOT_PENDING     0
+#define SYSTICK_PENDING         1
+
 typedef void (*systickCb_t)(void);
 
 /**
@@ -123,4 +126,20 @@ extern Std_ReturnType SysTick_ClearValue(void);
  */
 extern Std_ReturnType SysTick_SetTimeUS(uint32_t AHB_Clock, uint32_t timeUS);
 
+/**
+ * Function:  SysTick_IsPending 
+ * --------------------
+ *  @brief Checks if the SysTick interrupt is pending (the counter reached zero
+ *         but the handler did not run yet)
+ *
+ *  @param state: a pointer to return the state in
+ *                 @arg SYSTICK_PENDING
+ *                 @arg SYSTICK_NOT_PENDING
+ *  
+ *  @returns: A status
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+extern Std_ReturnType SysTick_IsPending(uint8_t* state);
+
 #endif
\ No newline at end of file
@@ -35,10 +35,12 @@
 
 #define UART_MODE_ASYNC                 0
 #define UART_MODE_DMA                   1
+#define UART_MODE_AUTO                  2
 
 typedef void (*txCb_t)(uint8_t);
 typedef void (*rxCb_t)(uint8_t);
 typedef void (*brCb_t)(uint8_t);
+typedef void (*rxChunkCb_t)(const uint8_t*, uint16_t, uint8_t);
 
 typedef struct
 {
@@ -64,7 +66,8 @@ typedef struct
 extern Std_ReturnType Uart_Init(Uart_cfg_t* cfgUart);
 
 /**
- * @brief Sends data through the UART
+ * @brief Sends data through the UART, the transfer waits for the bytes the transmit ring
+ * is sending and goes before the rest of the ring
  *
  * @param data The data to send
  * @param length the length of the data in bytes
@@ -73,10 +76,28 @@ extern Std_ReturnType Uart_Init(Uart_cfg_t* cfgUart);
  *                 @arg UART2
  *                 @arg UART3
  * @return Std_ReturnType A Status
- *                  E_OK: If the driver is ready to send
- *                  E_NOT_OK: If the driver can't send data right now
+ *                  E_OK: If the transfer is taken
+ *                  E_NOT_OK: If the data is not valid or the previous Uart_Send did not end
  */
 extern Std_ReturnType Uart_Send(uint8_t *data, uint16_t length, uint8_t uartModule);
+
+/**
+ * @brief Copies data to the transmit ring of the UART and returns, the interrupt
+ * (or the DMA in chunks in DMA mode) sends the ring back to back, the data can be reused right away
+ * (a Uart_Send goes between two turns of the ring on the transmit line)
+ *
+ * @param data The data to send
+ * @param length the length of the data in bytes
+ * @param written A place to return the number of bytes copied in (can be NULL)
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ * @return Std_ReturnType A Status
+ *                  E_OK: If all the data was copied
+ *                  E_NOT_OK: If the ring did not have space for all of it
+ */
+extern Std_ReturnType Uart_Write(const uint8_t *data, uint16_t length, uint16_t* written, uint8_t uartModule);
 /**
  * @brief Sends a Lin break of 13 bit length
  * 
@@ -174,4 +195,66 @@ extern Std_ReturnType Uart_SetRxCb(rxCb_t func, uint8_t uartModule);
  */
 extern Std_ReturnType Uart_SetBreakCb(brCb_t func, uint8_t uartModule);
 
+/**
+ * @brief Sets a ring buffer that takes every byte received while no Uart_Receive is running,
+ * the interrupt produces and a task consumes with Ring_Get or Ring_Read
+ * (Ring.h must be included before this file)
+ *
+ * @param ring the ring buffer (NULL to stop)
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+extern Std_ReturnType Uart_SetRxRing(ring_t* ring, uint8_t uartModule);
+
+/**
+ * @brief Starts a continuous reception, the DMA writes around the buffer without stopping
+ * and the callback gets the new bytes on the half transfer, the transfer complete and the idle line,
+ * it must take them before the DMA comes back around to them (DMA and Auto modes only)
+ *
+ * @param data the buffer the DMA writes in
+ * @param length the length of the buffer in bytes
+ * @param func the callback that takes the bytes
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the reception started
+ *                  E_NOT_OK: If a reception is running or the driver has no DMA
+ */
+extern Std_ReturnType Uart_StartRxCircular(uint8_t *data, uint16_t length, rxChunkCb_t func, uint8_t uartModule);
+
+/**
+ * @brief Stops the continuous reception, the bytes not handed to the callback yet are dropped
+ *
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the reception stopped
+ *                  E_NOT_OK: If no continuous reception is running
+ */
+extern Std_ReturnType Uart_StopRxCircular(uint8_t uartModule);
+
+/**
+ * @brief Sets the length from which a transfer of Uart_Send or Uart_Receive goes through
+ * the DMA, the shorter transfers go through the TX empty and RX not empty interrupts (Auto mode only)
+ *
+ * @param length the shortest transfer in bytes that uses the DMA
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the driver is not in Auto mode
+ */
+extern Std_ReturnType Uart_SetDmaThreshold(uint16_t length, uint8_t uartModule);
+
 #endif
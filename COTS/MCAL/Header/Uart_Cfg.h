@@ -12,6 +12,13 @@
 #ifndef UART_CFG_H
 #define UART_CFG_H
 
+/* UART_MODE_ASYNC, UART_MODE_DMA or UART_MODE_AUTO (every transfer picks by its length) */
 #define UART_MODE                   UART_MODE_ASYNC
 
+/* The shortest transfer in bytes that goes through the DMA in Auto mode (Uart_SetDmaThreshold changes it per module) */
+#define UART_DMA_THRESHOLD          16
+
+/* The size of the transmit ring of every module for Uart_Write in bytes (a power of two) */
+#define UART_TX_RING_SIZE           64
+
 #endif
\ No newline at end of file
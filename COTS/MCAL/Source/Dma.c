@@ -163,6 +163,28 @@ extern Std_ReturnType Dma_SetCallBack(uint8_t channelNumber, dmaCb_t callBack)
     return E_OK;
 }
 
+/**
+ * @brief Gets The Number Of Blocks Left To Transfer On A Certain DMA Channel
+ * (in circular mode it goes back to the full count after every pass)
+ * 
+ * @param channelNumber The DMA Channel Number
+ *                  @arg DMA_CH_x
+ * @param remaining A Place To Return The Number Of Blocks In
+ * @return Std_ReturnType 
+ *                  E_OK If the function was executed successfully
+ *                  E_NOT_OK If the function was not executed successfully
+ */
+extern Std_ReturnType Dma_GetRemaining(uint8_t channelNumber, uint16_t* remaining)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(channelNumber < DMA_NUMBER_OF_CHANNELS && remaining)
+    {
+        *remaining = (uint16_t)DMA->CH[channelNumber].CNDT;
+        error = E_OK;
+    }
+    return error;
+}
+
 /**
  * @brief Channel 1 Interrupt Handler
  * 
@@ -193,7 +215,7 @@ void DMA1_Channel2_IRQHandler(void)
  * @brief Channel 3 Interrupt Handler
  * 
  */
-void DMA1_Channe3_IRQHandler(void)
+void DMA1_Channel3_IRQHandler(void)
 {
     if(Dma_callBack[DMA_CH_3])
     {
@@ -0,0 +1,49 @@
+/**
+ * @file Dwt.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This is the implementation for the DWT cycle counter driver
+ * @version 0.1
+ * @date 2020-05-10
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#include "Std_Types.h"
+#include "Dwt.h"
+
+#define DWT_DEMCR                   *((volatile uint32_t*)0xE000EDFC)       /* The Debug Exception and Monitor Control Register */
+#define DWT_CTRL                    *((volatile uint32_t*)0xE0001000)       /* The DWT Control Register */
+#define DWT_CYCCNT                  *((volatile uint32_t*)0xE0001004)       /* The DWT Cycle Count Register */
+
+#define DWT_DEMCR_TRCENA_SET        0x01000000
+#define DWT_CTRL_CYCCNTENA_SET      0x00000001
+
+/**
+ * @brief Enables and resets the cycle counter
+ * 
+ * @return Std_ReturnType 
+ *                  E_OK If the function was executed successfully
+ *                  E_NOT_OK If the function was not executed successfully
+ */
+Std_ReturnType Dwt_Init(void)
+{
+    /* The DWT is powered by the trace enable bit */
+    DWT_DEMCR |= DWT_DEMCR_TRCENA_SET;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA_SET;
+    return E_OK;
+}
+
+/**
+ * @brief Reads the cycle counter
+ * 
+ * @param cycles A pointer to return the number of core cycles in
+ * @return Std_ReturnType 
+ *                  E_OK If the function was executed successfully
+ *                  E_NOT_OK If the function was not executed successfully
+ */
+Std_ReturnType Dwt_GetCycles(uint32_t* cycles)
+{
+    *cycles = DWT_CYCCNT;
+    return E_OK;
+}
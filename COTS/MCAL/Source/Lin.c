@@ -9,6 +9,7 @@
  *
  */
 #include "Std_Types.h"
+#include "Ring.h"
 #include "Uart.h"
 #include "Gpio.h"
 #include "Nvic.h"
@@ -12,6 +12,7 @@
 #define SYSTICK_CTRL            *((volatile uint32_t*)0xE000E010)       /* The SysTick Control Register */
 #define SYSTICK_LOAD            *((volatile uint32_t*)0xE000E014)       /* The SysTick Load Register */
 #define SYSTICK_VAL             *((volatile uint32_t*)0xE000E018)       /* The SysTick Value Register */
+#define SYSTICK_ICSR            *((volatile uint32_t*)0xE000ED04)       /* The Interrupt Control and State Register */
 
 #define SYSTICK_INT_EN       0x00000002
 #define SYSTICK_INT_DIS      0xFFFFFFFD
@@ -21,6 +22,8 @@
 
 #define SYSTICK_VALUE_MSK    0x00FFFFFF
 
+#define SYSTICK_PENDST_GET   0x04000000
+
 static systickCb_t SysTick_callBack = NULL;
 
 
@@ -186,3 +189,23 @@ Std_ReturnType SysTick_SetTimeUS(uint32_t AHB_Clock, uint32_t timeUS)
     SYSTICK_LOAD = (uint32_t)val;
     return E_OK;
 }
+
+/**
+ * Function:  SysTick_IsPending 
+ * --------------------
+ *  @brief Checks if the SysTick interrupt is pending (the counter reached zero
+ *         but the handler did not run yet)
+ *
+ *  @param state: a pointer to return the state in
+ *                 @arg SYSTICK_PENDING
+ *                 @arg SYSTICK_NOT_PENDING
+ *  
+ *  @returns: A status
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+Std_ReturnType SysTick_IsPending(uint8_t* state)
+{
+    *state = (SYSTICK_ICSR & SYSTICK_PENDST_GET) ? SYSTICK_PENDING : SYSTICK_NOT_PENDING;
+    return E_OK;
+}
\ No newline at end of file
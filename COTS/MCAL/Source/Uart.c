@@ -9,14 +9,33 @@
  *
  */
 #include "Std_Types.h"
+#include "Critical_Cfg.h"
+#include "Critical.h"
+#include "Ring.h"
 #include "Uart_Cfg.h"
 #include "Uart.h"
-#if UART_MODE == UART_MODE_DMA
+
+/* The paths the driver is built with, Auto mode has both and every transfer picks one */
+#define UART_USES_ASYNC               (UART_MODE == UART_MODE_ASYNC || UART_MODE == UART_MODE_AUTO)
+#define UART_USES_DMA                 (UART_MODE == UART_MODE_DMA || UART_MODE == UART_MODE_AUTO)
+
+#if UART_USES_DMA
 #include "Dma.h"
+#include "Nvic.h"
 #endif
 
 #define UART_NUMBER_OF_MODULES        3
 
+#if (UART_TX_RING_SIZE & (UART_TX_RING_SIZE - 1)) || UART_TX_RING_SIZE == 0
+#error "UART_TX_RING_SIZE must be a power of two"
+#endif
+#if UART_TX_RING_SIZE > 0x8000
+#error "UART_TX_RING_SIZE must fit in a chunk of the transmit ring"
+#endif
+
+/* The transmit ring goes out through the DMA in DMA mode and through the empty TX interrupt otherwise */
+#define UART_TX_RING_DMA              (UART_MODE == UART_MODE_DMA)
+
 /**
  * @brief The UART Registers
  * 
@@ -41,13 +60,20 @@ typedef struct
   uint8_t *ptr;   /* A pointer to the bytes of data */
   uint32_t pos;   /* The current position */
   uint32_t size;  /* The size of the data in the buffer */
-  uint8_t state;  /* The state of the buffer (UART_BUFFER_IDLE/UART_BUFFER_BUSY) */
+  uint8_t state;  /* The state of the buffer (UART_BUFFER_IDLE/UART_BUFFER_BUSY/UART_BUFFER_QUEUED) */
+  uint8_t dma;    /* 1 if the transfer goes through the DMA, 0 if it goes through the interrupts */
 } dataBuffer_t;
 
 #define UART_INT_NUMBER 37
 
 #define UART_BUFFER_IDLE 0
 #define UART_BUFFER_BUSY 1
+#define UART_BUFFER_QUEUED 2      /* A Uart_Send waiting for the transmit line */
+
+/* The owner of the transmit line, a Uart_Send transfer and the transmit ring take turns */
+#define UART_TX_LINE_IDLE 0
+#define UART_TX_LINE_SEND 1
+#define UART_TX_LINE_RING 2
 
 #define UART_TXE_CLR 0xFFFFFF7F
 #define UART_TC_CLR 0xFFFFFFBF
@@ -56,6 +82,9 @@ typedef struct
 #define UART_DR_CLR 0xFFFFFE00
 #define UART_STOP_CLR 0xFFFFCFFF
 #define UART_TXEIE_CLR 0xFFFFFF7F
+#define UART_TCIE_CLR 0xFFFFFFBF
+#define UART_RXNEIE_CLR 0xFFFFFFDF
+#define UART_IDLEIE_CLR 0xFFFFFFEF
 #define UART_PS_CLR 0xFFFFFDFF
 #define UART_M_CLR 0xFFFFEFFF
 #define UART_LBD_CLR 0xFFFFFEFF
@@ -64,6 +93,7 @@ typedef struct
 #define UART_TC_GET 0x00000040
 #define UART_RXNE_GET 0x00000020
 #define UART_PE_GET 0x00000001
+#define UART_IDLE_GET 0x00000010
 #define UART_UE_SET 0x00002000
 #define UART_PCE_SET 0x00000400
 #define UART_PEIE_SET 0x00000100
@@ -107,9 +137,51 @@ static volatile brCb_t appBreakNotify[UART_NUMBER_OF_MODULES];
 
 static volatile uint8_t Uart_interrupt[UART_NUMBER_OF_MODULES];
 
+static ring_t* volatile Uart_rxRing[UART_NUMBER_OF_MODULES];     /* The ring that takes the bytes received outside Uart_Receive */
+
 static volatile uint8_t  Uart_dmaRec[UART_NUMBER_OF_MODULES];
 
-#if UART_MODE == UART_MODE_DMA
+/* The bytes of Uart_Write, the caller produces and the interrupt drains them */
+static uint8_t Uart_txRingBuffer[UART_NUMBER_OF_MODULES][UART_TX_RING_SIZE];
+static ring_t Uart_txRing[UART_NUMBER_OF_MODULES];
+static volatile uint8_t Uart_txLine[UART_NUMBER_OF_MODULES];      /* The owner of the transmit line */
+static volatile uint16_t Uart_txChunk[UART_NUMBER_OF_MODULES];    /* The bytes of the transmit ring left in its turn on the line */
+
+#if UART_MODE == UART_MODE_AUTO
+/* The shortest transfer of every module that goes through the DMA */
+static volatile uint16_t Uart_dmaThreshold[UART_NUMBER_OF_MODULES] =
+{
+  UART_DMA_THRESHOLD,
+  UART_DMA_THRESHOLD,
+  UART_DMA_THRESHOLD
+};
+#endif
+
+#if UART_USES_DMA
+/**
+ * @brief The continuous reception, the DMA runs around the buffer and the new bytes
+ * are handed to the callback on the half transfer, the transfer complete and the idle line
+ * 
+ */
+typedef struct
+{
+  uint8_t *ptr;           /* The buffer the DMA writes in */
+  uint16_t size;          /* The size of the buffer */
+  uint16_t pos;           /* The position of the first byte not handed to the callback yet */
+  rxChunkCb_t callBack;   /* The callback that takes the bytes, NULL when stopped */
+} circularBuffer_t;
+
+static volatile circularBuffer_t Uart_rxCircular[UART_NUMBER_OF_MODULES];
+
+const uint8_t Uart_IrqNumber[UART_NUMBER_OF_MODULES] =
+{
+  NVIC_IRQNUM_USART1,
+  NVIC_IRQNUM_USART2,
+  NVIC_IRQNUM_USART3
+};
+#endif
+
+#if UART_USES_DMA
 const volatile uint8_t Uart_DmaTxChannelNumber[UART_NUMBER_OF_MODULES] =
 {
   DMA_CH_4,
@@ -128,6 +200,209 @@ static void USART1_DMA_IRQHandler(void);
 static void USART2_DMA_IRQHandler(void);
 static void USART3_DMA_IRQHandler(void);
 
+/**
+ * @brief Picks the path of a transfer, in Auto mode the short transfers go through
+ * the interrupts and the long ones through the DMA
+ * 
+ * @param length the length of the transfer in bytes
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ * @return uint8_t 1 for the DMA, 0 for the interrupts
+ */
+static uint8_t Uart_UseDma(uint16_t length, uint8_t uartModule)
+{
+#if UART_MODE == UART_MODE_AUTO
+  return (length >= Uart_dmaThreshold[uartModule]) ? 1 : 0;
+#else
+  (void)length;
+  (void)uartModule;
+  return (UART_MODE == UART_MODE_DMA) ? 1 : 0;
+#endif
+}
+
+#if UART_USES_DMA
+/**
+ * @brief Hands the bytes the DMA wrote since the last time to the callback,
+ * in two contiguous chunks when the DMA went around the end of the buffer
+ * 
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ */
+static void Uart_RxCircularPoll(uint8_t uartModule)
+{
+  volatile circularBuffer_t* circular = &Uart_rxCircular[uartModule];
+  uint16_t remaining;
+  uint16_t pos;
+  Dma_GetRemaining(Uart_DmaRxChannelNumber[uartModule], &remaining);
+  pos = circular->size - remaining;
+  /* The counter is reloaded at the end so the end is the start */
+  if (pos == circular->size)
+  {
+    pos = 0;
+  }
+  if (pos != circular->pos)
+  {
+    if (pos > circular->pos)
+    {
+      circular->callBack(&circular->ptr[circular->pos], pos - circular->pos, uartModule);
+    }
+    else
+    {
+      circular->callBack(&circular->ptr[circular->pos], circular->size - circular->pos, uartModule);
+      if (pos)
+      {
+        circular->callBack(circular->ptr, pos, uartModule);
+      }
+    }
+    circular->pos = pos;
+  }
+}
+#endif
+
+/**
+ * @brief Ends the Uart_Send transfer and gives up the transmit line
+ * 
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ */
+static void Uart_TxSendDone(uint8_t uartModule)
+{
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  /* The flag stays set while the line is idle */
+  Uart->CR1 &= UART_TCIE_CLR;
+  txBuffer[uartModule].ptr = NULL;
+  txBuffer[uartModule].size = 0;
+  txBuffer[uartModule].pos = 0;
+  Uart_txLine[uartModule] = UART_TX_LINE_IDLE;
+  txBuffer[uartModule].state = UART_BUFFER_IDLE;
+  if (appTxNotify[uartModule])
+  {
+    appTxNotify[uartModule](uartModule);
+  }
+}
+
+/**
+ * @brief Gives the idle transmit line to the waiting Uart_Send transfer, or else to the
+ * bytes the transmit ring holds now (called by the interrupt only)
+ * 
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ */
+static void Uart_TxArbitrate(uint8_t uartModule)
+{
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  ring_t* ring = &Uart_txRing[uartModule];
+  uint32_t count;
+#if UART_TX_RING_DMA
+  uint32_t tail;
+#endif
+  if (UART_TX_LINE_IDLE == Uart_txLine[uartModule])
+  {
+    if (UART_BUFFER_QUEUED == txBuffer[uartModule].state)
+    {
+#if UART_USES_DMA
+      if (txBuffer[uartModule].dma)
+      {
+        Uart_txLine[uartModule] = UART_TX_LINE_SEND;
+        txBuffer[uartModule].state = UART_BUFFER_BUSY;
+        /* The transfer complete interrupt marks the end of the transfer */
+        Uart->SR &= UART_TC_CLR;
+        Uart->CR1 |= UART_TCIE_SET;
+        Dma_TransferPrephData(Uart_DmaTxChannelNumber[uartModule], (uint32_t)(&(Uart->DR)), (uint32_t)txBuffer[uartModule].ptr, (uint16_t)txBuffer[uartModule].size);
+      }
+#endif
+#if UART_USES_ASYNC
+      if (0 == txBuffer[uartModule].dma)
+      {
+        if (UART_TXE_GET & Uart->SR)
+        {
+          Uart_txLine[uartModule] = UART_TX_LINE_SEND;
+          txBuffer[uartModule].state = UART_BUFFER_BUSY;
+          Uart->DR = txBuffer[uartModule].ptr[txBuffer[uartModule].pos++];
+          if (Uart_interrupt[uartModule] & UART_INTERRUPT_TXE)
+          {
+            Uart->CR1 |= UART_TXEIE_SET;
+          }
+          else
+          {
+            Uart->CR1 &= UART_TXEIE_CLR;
+          }
+          if (Uart_interrupt[uartModule] & UART_INTERRUPT_TC)
+          {
+            Uart->SR &= UART_TC_CLR;
+            Uart->CR1 |= UART_TCIE_SET;
+          }
+        }
+        else
+        {
+          /* The last byte of the ring is still in the data register, come back when it is out */
+          Uart->CR1 |= UART_TXEIE_SET;
+        }
+      }
+#endif
+    }
+    else
+    {
+      Ring_GetCount(ring, &count);
+      if (count)
+      {
+        Uart_txLine[uartModule] = UART_TX_LINE_RING;
+#if UART_TX_RING_DMA
+        tail = ring->tail & ring->mask;
+        /* A chunk does not go around the end of the ring */
+        if (count > ring->mask + 1 - tail)
+        {
+          count = ring->mask + 1 - tail;
+        }
+        Uart_txChunk[uartModule] = (uint16_t)count;
+        Uart->SR &= UART_TC_CLR;
+        Uart->CR1 |= UART_TCIE_SET;
+        Dma_TransferPrephData(Uart_DmaTxChannelNumber[uartModule], (uint32_t)(&(Uart->DR)), (uint32_t)&ring->buffer[tail], (uint16_t)count);
+#else
+        /* Only the bytes written so far, a Uart_Send waiting behind them goes next */
+        Uart_txChunk[uartModule] = (uint16_t)count;
+        /* The ring has the empty TX interrupt of its own whatever the configured interrupts,
+           the transmission complete would report a Uart_Send that never ran */
+        Uart->CR1 &= UART_TCIE_CLR;
+        Uart->CR1 |= UART_TXEIE_SET;
+#endif
+      }
+    }
+  }
+}
+
+/**
+ * @brief Makes the interrupt look at the transmit line
+ * 
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ */
+static void Uart_TxKick(uint8_t uartModule)
+{
+#if UART_MODE == UART_MODE_ASYNC
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  uint32_t primask;
+  /* The empty TX interrupt comes as soon as the data register is free, the interrupt also
+     writes CR1 so it must not run between the read and the write back of the bits it cleared */
+  CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+  Uart->CR1 |= UART_TXEIE_SET;
+  CRITICAL_RESTORE_INTERRUPTS(primask);
+#else
+  /* Only the interrupt starts a transfer so it never races with the end of another one */
+  Nvic_SetPending(Uart_IrqNumber[uartModule]);
+#endif
+}
+
 /**
  * @brief The Interrupt Handler for the UART driver
  * 
@@ -139,6 +414,9 @@ static void USART3_DMA_IRQHandler(void);
 static void UART_IRQHandler(uint8_t uartModule)
 {
   volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+#if UART_USES_ASYNC
+  uint8_t data;
+#endif
   /* If a Lin break is generated */
   if((UART_LBD_SET & Uart->SR) && (Uart_interrupt[uartModule] & UART_INTERRUPT_LBD))
   {
@@ -149,31 +427,40 @@ static void UART_IRQHandler(uint8_t uartModule)
       appBreakNotify[uartModule](uartModule);
     }
   }
-#if UART_MODE == UART_MODE_ASYNC
+#if UART_USES_ASYNC
   /* If the TX is Empty */
-  if ( (UART_TXE_GET & Uart->SR) && (Uart_interrupt[uartModule] & UART_INTERRUPT_TXE) )
+  if ( (UART_TXE_GET & Uart->SR) && (UART_TXEIE_SET & Uart->CR1) )
   {
-    /* If there is still data in the buffer */
-    if (txBuffer[uartModule].size != txBuffer[uartModule].pos)
+    if ( (UART_TX_LINE_SEND == Uart_txLine[uartModule]) && (0 == txBuffer[uartModule].dma) && (Uart_interrupt[uartModule] & UART_INTERRUPT_TXE) )
     {
-      Uart->DR = txBuffer[uartModule].ptr[txBuffer[uartModule].pos++];
+      /* If there is still data in the buffer */
+      if (txBuffer[uartModule].size != txBuffer[uartModule].pos)
+      {
+        Uart->DR = txBuffer[uartModule].ptr[txBuffer[uartModule].pos++];
+      }
+      else
+      {
+        Uart_TxSendDone(uartModule);
+      }
     }
-    else
+    else if ( (UART_TX_LINE_RING == Uart_txLine[uartModule]) && (E_OK == Ring_Get(&Uart_txRing[uartModule], &data)) )
     {
-      txBuffer[uartModule].ptr = NULL;
-      txBuffer[uartModule].size = 0;
-      txBuffer[uartModule].pos = 0;
-      txBuffer[uartModule].state = UART_BUFFER_IDLE;
-      Uart->CR1 &= UART_TXEIE_CLR;
-      if (appTxNotify[uartModule])
+      Uart->DR = data;
+      Uart_txChunk[uartModule]--;
+      if (0 == Uart_txChunk[uartModule])
       {
-        appTxNotify[uartModule](uartModule);
+        Uart_txLine[uartModule] = UART_TX_LINE_IDLE;
       }
     }
+    else
+    {
+      Uart->CR1 &= UART_TXEIE_CLR;
+    }
   }
 
   /* If the TX is Complete */
-  if ( (UART_TC_GET & Uart->SR) && (Uart_interrupt[uartModule] & UART_INTERRUPT_TC) )
+  if ( (UART_TC_GET & Uart->SR) && (UART_TX_LINE_SEND == Uart_txLine[uartModule]) && (0 == txBuffer[uartModule].dma) &&
+       (Uart_interrupt[uartModule] & UART_INTERRUPT_TC) )
   {
     /* Clear The Flag */
     Uart->SR &= UART_TC_CLR;
@@ -184,18 +471,13 @@ static void UART_IRQHandler(uint8_t uartModule)
     }
     else
     {
-      txBuffer[uartModule].ptr = NULL;
-      txBuffer[uartModule].size = 0;
-      txBuffer[uartModule].pos = 0;
-      txBuffer[uartModule].state = UART_BUFFER_IDLE;
-      if (appTxNotify[uartModule])
-      {
-        appTxNotify[uartModule](uartModule);
-      }
+      Uart_TxSendDone(uartModule);
     }
   }
 
-  if ( (UART_RXNE_GET & Uart->SR) && (Uart_interrupt[uartModule] & UART_INTERRUPT_RXNE))
+  /* The bytes of a DMA reception are left to the DMA */
+  if ( (UART_RXNE_GET & Uart->SR) && (Uart_interrupt[uartModule] & UART_INTERRUPT_RXNE) &&
+       !((UART_BUFFER_BUSY == rxBuffer[uartModule].state) && rxBuffer[uartModule].dma) )
   {
     Uart->SR &= UART_RXNE_CLR;
     /* If there is still data to receive */
@@ -216,30 +498,64 @@ static void UART_IRQHandler(uint8_t uartModule)
         }
       }
     }
+    else if (Uart_rxRing[uartModule])
+    {
+      /* The byte is dropped if the task did not keep up */
+      Ring_Put(Uart_rxRing[uartModule], (uint8_t)Uart->DR);
+    }
   }
 #endif
-#if UART_MODE == UART_MODE_DMA
+#if UART_USES_DMA
   /* If the Transmittion is Complete */
-  if ( (UART_TC_GET & Uart->SR) && (Uart_interrupt[uartModule] & UART_INTERRUPT_TC) )
+  if ( (UART_TC_GET & Uart->SR) && (UART_TCIE_SET & Uart->CR1) )
   {
-    /* Clear The Flag */
-    Uart->SR &= UART_TC_CLR;
-    txBuffer[uartModule].state = UART_BUFFER_IDLE;
-    if (appTxNotify[uartModule])
+    if ( (UART_TX_LINE_SEND == Uart_txLine[uartModule]) && txBuffer[uartModule].dma )
     {
-      appTxNotify[uartModule](uartModule);
+      /* Clear The Flag */
+      Uart->SR &= UART_TC_CLR;
+      Uart_TxSendDone(uartModule);
+    }
+#if UART_TX_RING_DMA
+    else if (UART_TX_LINE_RING == Uart_txLine[uartModule])
+    {
+      Uart->SR &= UART_TC_CLR;
+      Uart->CR1 &= UART_TCIE_CLR;
+      /* The chunk of the transmit ring is sent, its place is free again */
+      RING_BARRIER();
+      Uart_txRing[uartModule].tail += Uart_txChunk[uartModule];
+      Uart_txChunk[uartModule] = 0;
+      Uart_txLine[uartModule] = UART_TX_LINE_IDLE;
+    }
+#endif
+  }
+  if (Uart_rxCircular[uartModule].callBack)
+  {
+    /* Reading the status then the data clears the idle line flag */
+    if (UART_IDLE_GET & Uart->SR)
+    {
+      (void)Uart->DR;
     }
+    Uart_dmaRec[uartModule] = DMA_DID_NOT_RECEIVE;
+    Uart_RxCircularPoll(uartModule);
   }
-  if(Uart_dmaRec[uartModule] == DMA_RECEIVED)
+  else if(Uart_dmaRec[uartModule] == DMA_RECEIVED)
   {
-    Uart_dmaRec[UART2] = DMA_DID_NOT_RECEIVE;
+    Uart_dmaRec[uartModule] = DMA_DID_NOT_RECEIVE;
     rxBuffer[uartModule].state = UART_BUFFER_IDLE;
+#if UART_MODE == UART_MODE_AUTO
+    if (Uart_rxRing[uartModule])
+    {
+      Uart->CR1 |= UART_RXNEIE_SET;
+    }
+#endif
     if (appRxNotify[uartModule])
     {
       appRxNotify[uartModule](uartModule);
     }
   }
 #endif
+  /* The transmit line goes on as soon as it is idle */
+  Uart_TxArbitrate(uartModule);
 }
 
 
@@ -255,7 +571,7 @@ Std_ReturnType Uart_Init(Uart_cfg_t* cfgUart)
 {
   volatile uart_t* Uart = (volatile uart_t*)Uart_Address[cfgUart->uartModule];
   f64 tmpBaudRate = ((f64)cfgUart->sysClk / ((f64)cfgUart->baudRate));
-#if UART_MODE == UART_MODE_DMA
+#if UART_USES_DMA
   /* Tx Configurations */
   dmaPrephCfg_t cfg = 
   {
@@ -293,7 +609,7 @@ Std_ReturnType Uart_Init(Uart_cfg_t* cfgUart)
   }
   /* Set the hardware flowcontrol */
   Uart->CR3 &= UART_RTSE_CLR;
-#if UART_MODE == UART_MODE_DMA
+#if UART_USES_DMA
   /* DMA Configurations */
   Dma_ConfigurePrephChannel(&cfg);
   /* Rx Configure */
@@ -317,22 +633,23 @@ Std_ReturnType Uart_Init(Uart_cfg_t* cfgUart)
 #endif
   Uart->CR3 |= cfgUart->flowControl;
   Uart->GTPR |= UART_NO_PRESCALER;
+  Ring_Init(&Uart_txRing[cfgUart->uartModule], Uart_txRingBuffer[cfgUart->uartModule], UART_TX_RING_SIZE);
   /* Set the buffer states to idle */
   rxBuffer[cfgUart->uartModule].state = UART_BUFFER_IDLE;
   txBuffer[cfgUart->uartModule].state = UART_BUFFER_IDLE;
+  Uart_txLine[cfgUart->uartModule] = UART_TX_LINE_IDLE;
+  Uart_txChunk[cfgUart->uartModule] = 0;
+  rxBuffer[cfgUart->uartModule].dma = Uart_UseDma(0, cfgUart->uartModule);
+  txBuffer[cfgUart->uartModule].dma = Uart_UseDma(0, cfgUart->uartModule);
   Uart->SR &= UART_TC_CLR;
-#if UART_MODE == UART_MODE_DMA
-  /* Enable the UART, Receiver, Transmitter and the Receiver not empty interrupt */
-  Uart->CR1 |= UART_UE_SET | UART_TE_SET | UART_RE_SET | (UART_TCIE_SET & cfgUart->interrupts) | (UART_LBDIE_SET & cfgUart->interrupts);
-#else
-  /* Enable the UART, Receiver, Transmitter and the Receiver not empty interrupt */
-  Uart->CR1 |= UART_UE_SET | UART_TE_SET | UART_RE_SET | (UART_LBDIE_SET & cfgUart->interrupts);;
-#endif
+  /* Enable the UART, Receiver and Transmitter, the TX interrupts are enabled by every transfer */
+  Uart->CR1 |= UART_UE_SET | UART_TE_SET | UART_RE_SET | (UART_LBDIE_SET & cfgUart->interrupts);
   return E_OK;
 }
 
 /**
- * @brief Sends data through the UART
+ * @brief Sends data through the UART, the transfer waits for the bytes the transmit ring
+ * is sending and goes before the rest of the ring
  *
  * @param data The data to send
  * @param length the length of the data in bytes
@@ -341,44 +658,61 @@ Std_ReturnType Uart_Init(Uart_cfg_t* cfgUart)
  *                 @arg UART2
  *                 @arg UART3
  * @return Std_ReturnType A Status
- *                  E_OK: If the driver is ready to send
- *                  E_NOT_OK: If the driver can't send data right now
+ *                  E_OK: If the transfer is taken
+ *                  E_NOT_OK: If the data is not valid or the previous Uart_Send did not end
  */
 Std_ReturnType Uart_Send(uint8_t *data, uint16_t length, uint8_t uartModule)
 {
   Std_ReturnType error = E_NOT_OK;
-  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
   /*If there is valid data and length and the TX buffer is idle*/
-  if (data && (length > 0) && txBuffer[uartModule].state == UART_BUFFER_IDLE)
+  if (data && (length > 0) && uartModule < UART_NUMBER_OF_MODULES && txBuffer[uartModule].state == UART_BUFFER_IDLE)
   {
-
-#if UART_MODE == UART_MODE_ASYNC
-    txBuffer[uartModule].state = UART_BUFFER_BUSY;
     txBuffer[uartModule].ptr = data;
     txBuffer[uartModule].pos = 0;
     txBuffer[uartModule].size = length;
-
-    Uart->DR = txBuffer[uartModule].ptr[txBuffer[uartModule].pos++];
-    if(Uart_interrupt[uartModule] & UART_INTERRUPT_TXE)
+    txBuffer[uartModule].dma = Uart_UseDma(length, uartModule);
+    /* The interrupt starts it once the transmit line is idle */
+    txBuffer[uartModule].state = UART_BUFFER_QUEUED;
+    Uart_TxKick(uartModule);
+    error = E_OK;
+  }
+  return error;
+}
+/**
+ * @brief Copies data to the transmit ring of the UART and returns, the interrupt
+ * (or the DMA in chunks in DMA mode) sends the ring back to back, the data can be reused right away
+ * (a Uart_Send goes between two turns of the ring on the transmit line)
+ *
+ * @param data The data to send
+ * @param length the length of the data in bytes
+ * @param written A place to return the number of bytes copied in (can be NULL)
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ * @return Std_ReturnType A Status
+ *                  E_OK: If all the data was copied
+ *                  E_NOT_OK: If the ring did not have space for all of it
+ */
+Std_ReturnType Uart_Write(const uint8_t *data, uint16_t length, uint16_t* written, uint8_t uartModule)
+{
+  Std_ReturnType error = E_NOT_OK;
+  uint32_t copied = 0;
+  if (data && uartModule < UART_NUMBER_OF_MODULES)
+  {
+    error = Ring_Write(&Uart_txRing[uartModule], data, length, &copied);
+    if (copied)
     {
-        Uart->CR1 |= UART_TXEIE_SET;
-    }
-    if(Uart_interrupt[uartModule] & UART_INTERRUPT_TC)
-    {   
-      Uart->SR &= UART_TC_CLR;
-      Uart->CR1 |= UART_TCIE_SET;;
+      Uart_TxKick(uartModule);
     }
-#endif
-
-#if UART_MODE == UART_MODE_DMA
-    txBuffer[uartModule].state = UART_BUFFER_BUSY;
-    Dma_TransferPrephData(Uart_DmaTxChannelNumber[uartModule],(uint32_t)(&(Uart->DR)), (uint32_t)data, length);
-#endif
-
-    error = E_OK;
+  }
+  if (written)
+  {
+    *written = (uint16_t)copied;
   }
   return error;
 }
+
 /**
  * @brief Receives data through the UART
  *
@@ -399,21 +733,29 @@ Std_ReturnType Uart_Receive(uint8_t *data, uint16_t length, uint8_t uartModule)
   /* If the RX buffer is idle */
   if (rxBuffer[uartModule].state == UART_BUFFER_IDLE)
   {
-
-#if UART_MODE == UART_MODE_ASYNC
-    rxBuffer[uartModule].ptr = data;
-    rxBuffer[uartModule].size = length;
-    rxBuffer[uartModule].pos = 0;
-    rxBuffer[uartModule].state = UART_BUFFER_BUSY;
-    if(Uart_interrupt[uartModule] & UART_INTERRUPT_RXNE)
-    {   
-      Uart->CR1 |= UART_RXNEIE_SET;
+    rxBuffer[uartModule].dma = Uart_UseDma(length, uartModule);
+#if UART_USES_ASYNC
+    if (0 == rxBuffer[uartModule].dma)
+    {
+      rxBuffer[uartModule].ptr = data;
+      rxBuffer[uartModule].size = length;
+      rxBuffer[uartModule].pos = 0;
+      rxBuffer[uartModule].state = UART_BUFFER_BUSY;
+      if(Uart_interrupt[uartModule] & UART_INTERRUPT_RXNE)
+      {   
+        Uart->CR1 |= UART_RXNEIE_SET;
+      }
     }
 #endif
 
-#if UART_MODE == UART_MODE_DMA
-    rxBuffer[uartModule].state = UART_BUFFER_BUSY;
-    Dma_TransferPrephData(Uart_DmaRxChannelNumber[uartModule],(uint32_t)(&(Uart->DR)), (uint32_t)data, length);
+#if UART_USES_DMA
+    if (rxBuffer[uartModule].dma)
+    {
+      rxBuffer[uartModule].state = UART_BUFFER_BUSY;
+      /* The receive ring must not take the bytes from the DMA */
+      Uart->CR1 &= UART_RXNEIE_CLR;
+      Dma_TransferPrephData(Uart_DmaRxChannelNumber[uartModule],(uint32_t)(&(Uart->DR)), (uint32_t)data, length);
+    }
 #endif
 
     error = E_OK;
@@ -541,6 +883,176 @@ Std_ReturnType Uart_SetBreakCb(brCb_t func, uint8_t uartModule)
   return E_OK;
 }
 
+/**
+ * @brief Sets a ring buffer that takes every byte received while no Uart_Receive is running,
+ * the interrupt produces and a task consumes with Ring_Get or Ring_Read
+ *
+ * @param ring the ring buffer (NULL to stop)
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the did not execute successfully
+ */
+Std_ReturnType Uart_SetRxRing(ring_t* ring, uint8_t uartModule)
+{
+  Std_ReturnType error = E_NOT_OK;
+#if UART_USES_ASYNC
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  if (uartModule < UART_NUMBER_OF_MODULES)
+  {
+    Uart_rxRing[uartModule] = ring;
+    if (ring && !((UART_BUFFER_BUSY == rxBuffer[uartModule].state) && rxBuffer[uartModule].dma))
+    {
+      Uart->CR1 |= UART_RXNEIE_SET;
+    }
+    else if (UART_BUFFER_IDLE == rxBuffer[uartModule].state)
+    {
+      Uart->CR1 &= UART_RXNEIE_CLR;
+    }
+    error = E_OK;
+  }
+#endif
+  return error;
+}
+
+/**
+ * @brief Starts a continuous reception, the DMA writes around the buffer without stopping
+ * and the callback gets the new bytes on the half transfer, the transfer complete and the idle line,
+ * it must take them before the DMA comes back around to them (DMA and Auto modes only)
+ *
+ * @param data the buffer the DMA writes in
+ * @param length the length of the buffer in bytes
+ * @param func the callback that takes the bytes
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the reception started
+ *                  E_NOT_OK: If a reception is running or the driver has no DMA
+ */
+Std_ReturnType Uart_StartRxCircular(uint8_t *data, uint16_t length, rxChunkCb_t func, uint8_t uartModule)
+{
+  Std_ReturnType error = E_NOT_OK;
+#if UART_USES_DMA
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  dmaPrephCfg_t cfg =
+  {
+    .channel = Uart_DmaRxChannelNumber[uartModule],
+    .interrupt = DMA_INT_HALF_TRANSFER | DMA_INT_TRANSFER_COMPLETE,
+    .direction = DMA_READ_FROM_PREPH,
+    .circular = DMA_CIRCULAR_MODE_ON,
+    .prephInc = DMA_PREPH_INC_OFF,
+    .memInc = DMA_MEM_INC_ON,
+    .prephSize = DMA_PREPH_8_BIT,
+    .memSize = DMA_MEM_8_BIT,
+    .priority = DMA_PRIORITY_HIGH
+  };
+  if (uartModule < UART_NUMBER_OF_MODULES && data && length > 1 && func &&
+      UART_BUFFER_IDLE == rxBuffer[uartModule].state)
+  {
+    rxBuffer[uartModule].state = UART_BUFFER_BUSY;
+    rxBuffer[uartModule].dma = 1;
+    Uart->CR1 &= UART_RXNEIE_CLR;
+    Uart_rxCircular[uartModule].ptr = data;
+    Uart_rxCircular[uartModule].size = length;
+    Uart_rxCircular[uartModule].pos = 0;
+    Uart_rxCircular[uartModule].callBack = func;
+    Dma_ConfigurePrephChannel(&cfg);
+    Dma_TransferPrephData(Uart_DmaRxChannelNumber[uartModule], (uint32_t)(&(Uart->DR)), (uint32_t)data, length);
+    Uart->CR1 |= UART_IDLEIE_SET;
+    error = E_OK;
+  }
+#else
+  (void)data;
+  (void)length;
+  (void)func;
+  (void)uartModule;
+#endif
+  return error;
+}
+
+/**
+ * @brief Stops the continuous reception, the bytes not handed to the callback yet are dropped
+ *
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the reception stopped
+ *                  E_NOT_OK: If no continuous reception is running
+ */
+Std_ReturnType Uart_StopRxCircular(uint8_t uartModule)
+{
+  Std_ReturnType error = E_NOT_OK;
+#if UART_USES_DMA
+  volatile uart_t* Uart = (volatile uart_t*)Uart_Address[uartModule];
+  /* Back to the single transfers of Uart_Receive */
+  dmaPrephCfg_t cfg =
+  {
+    .channel = Uart_DmaRxChannelNumber[uartModule],
+    .interrupt = DMA_INT_TRANSFER_COMPLETE,
+    .direction = DMA_READ_FROM_PREPH,
+    .circular = DMA_CIRCULAR_MODE_OFF,
+    .prephInc = DMA_PREPH_INC_OFF,
+    .memInc = DMA_MEM_INC_ON,
+    .prephSize = DMA_PREPH_8_BIT,
+    .memSize = DMA_MEM_8_BIT,
+    .priority = DMA_PRIORITY_HIGH
+  };
+  if (uartModule < UART_NUMBER_OF_MODULES && Uart_rxCircular[uartModule].callBack)
+  {
+    Uart->CR1 &= UART_IDLEIE_CLR;
+    Dma_ConfigurePrephChannel(&cfg);
+    Uart_rxCircular[uartModule].callBack = NULL;
+    rxBuffer[uartModule].state = UART_BUFFER_IDLE;
+#if UART_MODE == UART_MODE_AUTO
+    if (Uart_rxRing[uartModule])
+    {
+      Uart->CR1 |= UART_RXNEIE_SET;
+    }
+#endif
+    error = E_OK;
+  }
+#else
+  (void)uartModule;
+#endif
+  return error;
+}
+
+/**
+ * @brief Sets the length from which a transfer of Uart_Send or Uart_Receive goes through
+ * the DMA, the shorter transfers go through the TX empty and RX not empty interrupts (Auto mode only)
+ *
+ * @param length the shortest transfer in bytes that uses the DMA
+ * @param uartModule the module number of the UART
+ *                 @arg UART1
+ *                 @arg UART2
+ *                 @arg UART3
+ * @return Std_ReturnType A Status
+ *                  E_OK: If the function executed successfully
+ *                  E_NOT_OK: If the driver is not in Auto mode
+ */
+Std_ReturnType Uart_SetDmaThreshold(uint16_t length, uint8_t uartModule)
+{
+  Std_ReturnType error = E_NOT_OK;
+#if UART_MODE == UART_MODE_AUTO
+  if (uartModule < UART_NUMBER_OF_MODULES)
+  {
+    Uart_dmaThreshold[uartModule] = length;
+    error = E_OK;
+  }
+#else
+  (void)length;
+  (void)uartModule;
+#endif
+  return error;
+}
+
 /**
  * @brief Sends a Lin break of 13 bit length
  * 
@@ -9,13 +9,89 @@
  * 
  */
 #include "Std_Types.h"
+#include "Critical_Cfg.h"
+#include "Critical.h"
 #include "SysTick.h"
 #include "Sched_Cfg.h"
 #include "Sched.h"
+#if SCHED_TASK_STATS == STD_ON
+#include "Dwt.h"
+#endif
+#if SCHED_SOFTWARE_TIMERS == STD_ON
+#include "Timer.h"
+#endif
 
+#define SCHED_TASK_FREE                  0
 #define SCHED_TASK_RUNNING               1
 #define SCHED_TASK_SUSPENDED             2
 
+#define SCHED_NO_TASK                    0xFF
+
+#if SCHED_MAX_NUMBER_OF_TASKS >= SCHED_NO_TASK
+#error "SCHED_MAX_NUMBER_OF_TASKS must be less than 255"
+#endif
+
+#if SCHED_MAX_NUMBER_OF_TASKS < SCHED_NUMBER_OF_TASKS
+#error "SCHED_MAX_NUMBER_OF_TASKS must hold the configured tasks"
+#endif
+
+#define SCHED_READY_WORDS                ((SCHED_MAX_NUMBER_OF_TASKS + 31) / 32)
+
+#define SCHED_TICK_COUNTS                (SCHED_AHB_CLK / 1000 * SCHED_TICK_TIME_MS)    /* SysTick counts in one tick */
+#define SCHED_TICK_US                    (SCHED_TICK_TIME_MS * 1000)
+
+#if SCHED_TASK_STATS == STD_ON
+#define SCHED_TICK_CYCLES                (SCHED_CPU_CLK / 1000 * SCHED_TICK_TIME_MS)    /* Core cycles in one tick */
+#endif
+
+#if SCHED_CATCHUP_POLICY == SCHED_CATCHUP_DROP_LOW_PRIORITY
+#define SCHED_DROP_PERIOD_TICKS          (SCHED_CATCHUP_DROP_PERIOD_MS / SCHED_TICK_TIME_MS)
+#endif
+
+#if SCHED_TICKLESS_IDLE == STD_ON
+#define SCHED_SYSTICK_MAX_COUNTS         0x00FFFFFF                                     /* The SysTick is a 24 bit counter */
+#define SCHED_MAX_IDLE_TICKS             (SCHED_SYSTICK_MAX_COUNTS / SCHED_TICK_COUNTS)
+#define SCHED_IDLE_GUARD_COUNTS          (SCHED_TICK_COUNTS / 8)                        /* Too close to the tick to reprogram */
+#endif
+
+#if SCHED_MODE == SCHED_MODE_PREEMPTIVE
+#if SCHED_TICKLESS_IDLE == STD_ON
+#error "The tickless idle is only supported by the cooperative scheduler"
+#endif
+#define SCHED_IDLE_THREAD                SCHED_MAX_NUMBER_OF_TASKS                      /* The thread that runs when no task is ready */
+#define SCHED_IDLE_STACK_SIZE            128
+#define SCHED_STACK_FRAME_WORDS          16                                             /* r4-r11 then r0-r3, r12, lr, pc and xpsr */
+#define SCHED_STACK_FRAME_R0             8
+#define SCHED_STACK_FRAME_LR             13
+#define SCHED_STACK_FRAME_PC             14
+#define SCHED_STACK_FRAME_XPSR           15
+#define SCHED_INITIAL_XPSR               0x01000000                                     /* The thumb state bit */
+#define SCHED_ICSR                       *((volatile uint32_t*)0xE000ED04)              /* The Interrupt Control and State Register */
+#define SCHED_ICSR_PENDSVSET             0x10000000
+#define SCHED_SHPR3                      *((volatile uint32_t*)0xE000ED20)              /* The System Handler Priority Register 3 */
+#define SCHED_SHPR3_CLR_MASK             0x0000FFFF
+#define SCHED_SHPR3_PRIORITIES           0xF0FF0000                                     /* PendSV the lowest and SysTick right above it */
+#define SCHED_PEND_SWITCH()              (SCHED_ICSR = SCHED_ICSR_PENDSVSET)
+#define SCHED_SET_PSP(sp)                __asm volatile ("msr psp, %0" : : "r" (sp) : "memory")
+#define SCHED_USE_PSP()                  __asm volatile ("mrs r0, control\n\torr r0, r0, #2\n\tmsr control, r0\n\tisb" : : : "r0", "memory")
+#endif
+
+/* A host build can define SCHED_HOST_SIM and give the three functions to simulate the core (Tools/SchedTicklessSim.c) */
+#if !defined(__arm__) && defined(SCHED_HOST_SIM)
+extern void Sched_HostWaitForInterrupt(void);
+extern void Sched_HostDisableInterrupts(void);
+extern void Sched_HostEnableInterrupts(void);
+#define SCHED_WAIT_FOR_INTERRUPT()       Sched_HostWaitForInterrupt()
+
+#define SCHED_DISABLE_INTERRUPTS()       Sched_HostDisableInterrupts()
+#define SCHED_ENABLE_INTERRUPTS()        Sched_HostEnableInterrupts()
+#else
+#define SCHED_WAIT_FOR_INTERRUPT()       __asm volatile ("wfi" : : : "memory")
+
+#define SCHED_DISABLE_INTERRUPTS()       __asm volatile ("cpsid i" : : : "memory")
+#define SCHED_ENABLE_INTERRUPTS()        __asm volatile ("cpsie i" : : : "memory")
+#endif
+
 /**
  * @brief The System task
  * 
@@ -23,27 +99,690 @@
 typedef struct
 {
     const sysTaskInfo_t* taskInfo;  /* The system task information */
-    uint32_t remainToExec;          /* The remaining ticks to execute */
-    uint32_t periodTicks;           /* The periodic time in ticks */
+    uint32_t remainToExec;          /* The remaining ticks to execute after the previous task in the due list */
+    uint32_t periodTicks;           /* The periodic time in ticks (0 for event activated tasks) */
+    uint32_t priorityKey;           /* The lower key runs first among the tasks due on the same tick */
     uint8_t state;                  /* The state of the current task */
+    uint8_t next;                   /* The next task in the due list */
+#if SCHED_TASK_STATS == STD_ON
+    uint32_t lastCycles;            /* The execution time of the last run in cycles */
+    uint32_t minCycles;             /* The shortest execution time in cycles */
+    uint32_t maxCycles;             /* The longest execution time in cycles */
+    uint64_t totalCycles;           /* The sum of all the execution times in cycles */
+    uint32_t activations;           /* The number of runs */
+    uint32_t overruns;              /* The number of runs longer than a tick */
+#endif
+#if SCHED_MODE == SCHED_MODE_PREEMPTIVE
+    uint8_t pendingRuns;            /* The releases that did not finish running yet */
+#endif
 } sysTask_t;
 
 extern const sysTaskInfo_t Sched_sysTaskInfo[SCHED_NUMBER_OF_TASKS];
 
-static sysTask_t Sched_task[SCHED_NUMBER_OF_TASKS];
+/* The configured tasks take the first slots, the rest are free for Sched_CreateTask */
+static sysTask_t Sched_task[SCHED_MAX_NUMBER_OF_TASKS];
+
+static volatile uint32_t Sched_pendingTicks;       /* The ticks that still need a scheduler pass */
 
-static volatile uint8_t Sched_flag;
+static schedTickStats_t Sched_tickStats;
+
+static volatile uint32_t Sched_tickCount;          /* The ticks since the scheduler started, the micro seconds time base */
 
 static volatile uint8_t Sched_taskItr;
 
+#if SCHED_MODE == SCHED_MODE_COOPERATIVE
+static uint8_t Sched_dueRun;                        /* Set while the task runs from the due list and is out of it */
+#endif
+
+/* The tasks activated by Sched_ActivateTask, or all the released tasks waiting for the core in the preemptive mode */
+static volatile uint32_t Sched_readyMask[SCHED_READY_WORDS];
+static volatile uint8_t Sched_activated;                        /* Set when any bit of the ready mask is set */
+
+#if SCHED_MODE == SCHED_MODE_PREEMPTIVE
+static uint32_t Sched_stack[SCHED_MAX_NUMBER_OF_TASKS][SCHED_TASK_STACK_SIZE / 4] __attribute__((aligned(8)));
+static uint32_t Sched_idleStack[SCHED_IDLE_STACK_SIZE / 4] __attribute__((aligned(8)));
+static uint32_t* Sched_stackPointer[SCHED_MAX_NUMBER_OF_TASKS + 1];    /* The saved stack of every thread, the idle thread is the last */
+static volatile uint8_t Sched_running = SCHED_IDLE_THREAD;              /* The thread that owns the core */
+#endif
+
+/* The running tasks sorted by their due tick, each one holding the ticks after the one before it,
+   so a tick only touches the head of the list and the tasks that are due */
+static uint8_t Sched_dueHead = SCHED_NO_TASK;
+
+#if SCHED_TICKLESS_IDLE == STD_ON
+static volatile uint32_t Sched_idleTicks;           /* The ticks slept through on purpose, no task was due in them */
+static volatile uint32_t Sched_countingTicks = 1;   /* The ticks the current SysTick period is counting */
+static volatile uint32_t Sched_reloadTicks = 1;     /* The ticks the SysTick reload value holds */
+static volatile uint8_t Sched_deadlineMoved;        /* Set by Sched_NewDeadline, a stretch worked out before it may be too long */
+#endif
+
+#if SCHED_MODE == SCHED_MODE_COOPERATIVE
 /**
- * @brief Sets the scheduler flag
+ * @brief Counts a tick that needs a scheduler pass
  * 
  */
 static void Sched_SetFlag(void)
 {
-    Sched_flag = 1;
+#if SCHED_TICKLESS_IDLE == STD_ON
+    Sched_tickCount += Sched_countingTicks;
+    /* Only the last tick of a stretched period has a due task */
+    Sched_idleTicks += Sched_countingTicks - 1;
+    /* The counter has just reloaded so it is counting whatever the reload value holds */
+    Sched_countingTicks = Sched_reloadTicks;
+    if(1 != Sched_reloadTicks)
+    {
+        /* Go back to the normal tick when the stretched period ends */
+        SysTick_SetReloadValue(SCHED_TICK_COUNTS);
+        Sched_reloadTicks = 1;
+    }
+#else
+    Sched_tickCount++;
+#endif
+    Sched_pendingTicks++;
+}
+#endif
+
+/**
+ * @brief Runs a task and records its execution time
+ *        (in the preemptive mode this includes the time taken by the higher priority tasks)
+ * 
+ * @param taskIndex The index of the task
+ */
+static void Sched_RunTask(uint8_t taskIndex)
+{
+#if SCHED_TASK_STATS == STD_ON
+    uint32_t start;
+    uint32_t end;
+    uint32_t cycles;
+    Dwt_GetCycles(&start);
+    Sched_task[taskIndex].taskInfo->task->runnable();
+    Dwt_GetCycles(&end);
+    /* The unsigned subtraction survives the counter wrapping */
+    cycles = end - start;
+    Sched_task[taskIndex].lastCycles = cycles;
+    if(cycles < Sched_task[taskIndex].minCycles)
+    {
+        Sched_task[taskIndex].minCycles = cycles;
+    }
+    if(cycles > Sched_task[taskIndex].maxCycles)
+    {
+        Sched_task[taskIndex].maxCycles = cycles;
+    }
+    if(cycles > SCHED_TICK_CYCLES)
+    {
+        Sched_task[taskIndex].overruns++;
+    }
+    Sched_task[taskIndex].totalCycles += cycles;
+    Sched_task[taskIndex].activations++;
+#else
+    Sched_task[taskIndex].taskInfo->task->runnable();
+#endif
+}
+
+/**
+ * @brief Checks if a task has a higher priority than another one
+ * 
+ * @param taskIndex The index of the task
+ * @param otherIndex The index of the other task
+ * @return uint8_t 1 if the task runs first, 0 if not
+ */
+static uint8_t Sched_RunsBefore(uint8_t taskIndex, uint8_t otherIndex)
+{
+    uint8_t before = 0;
+    if(Sched_task[taskIndex].priorityKey < Sched_task[otherIndex].priorityKey)
+    {
+        before = 1;
+    }
+    else if(Sched_task[taskIndex].priorityKey == Sched_task[otherIndex].priorityKey && taskIndex < otherIndex)
+    {
+        /* The equal keys run in the index order */
+        before = 1;
+    }
+    return before;
+}
+
+/**
+ * @brief Inserts a task in the due list
+ * 
+ * @param taskIndex The index of the task, its remainToExec holds the ticks from now
+ */
+static void Sched_InsertTask(uint8_t taskIndex)
+{
+    uint8_t prev = SCHED_NO_TASK;
+    uint8_t curr = Sched_dueHead;
+    uint32_t ticks = Sched_task[taskIndex].remainToExec;
+    /* Tasks due on the same tick are kept in their priority order */
+    while(SCHED_NO_TASK != curr && (Sched_task[curr].remainToExec < ticks ||
+          (Sched_task[curr].remainToExec == ticks && Sched_RunsBefore(curr, taskIndex))))
+    {
+        ticks -= Sched_task[curr].remainToExec;
+        prev = curr;
+        curr = Sched_task[curr].next;
+    }
+    Sched_task[taskIndex].remainToExec = ticks;
+    Sched_task[taskIndex].next = curr;
+    if(SCHED_NO_TASK != curr)
+    {
+        Sched_task[curr].remainToExec -= ticks;
+    }
+    if(SCHED_NO_TASK == prev)
+    {
+        Sched_dueHead = taskIndex;
+    }
+    else
+    {
+        Sched_task[prev].next = taskIndex;
+    }
+}
+
+/**
+ * @brief Removes a task from the due list if it is there
+ * 
+ * @param taskIndex The index of the task
+ */
+static void Sched_RemoveTask(uint8_t taskIndex)
+{
+    uint8_t prev = SCHED_NO_TASK;
+    uint8_t curr = Sched_dueHead;
+    while(SCHED_NO_TASK != curr && taskIndex != curr)
+    {
+        prev = curr;
+        curr = Sched_task[curr].next;
+    }
+    if(SCHED_NO_TASK != curr)
+    {
+        /* The next task keeps its due tick */
+        if(SCHED_NO_TASK != Sched_task[curr].next)
+        {
+            Sched_task[Sched_task[curr].next].remainToExec += Sched_task[curr].remainToExec;
+        }
+        if(SCHED_NO_TASK == prev)
+        {
+            Sched_dueHead = Sched_task[curr].next;
+        }
+        else
+        {
+            Sched_task[prev].next = Sched_task[curr].next;
+        }
+    }
+}
+
+#if SCHED_MODE == SCHED_MODE_PREEMPTIVE
+/**
+ * @brief Gets the highest priority task that is ready
+ * 
+ * @return uint8_t The index of the task or the idle thread
+ */
+static uint8_t Sched_HighestReady(void)
+{
+    uint8_t word;
+    uint8_t taskIndex;
+    uint32_t ready;
+    uint8_t highest = SCHED_IDLE_THREAD;
+    for(word=0; word<SCHED_READY_WORDS; word++)
+    {
+        ready = Sched_readyMask[word];
+        while(ready)
+        {
+            taskIndex = (word * 32) + __builtin_ctz(ready);
+            ready &= ready - 1;
+            if(SCHED_IDLE_THREAD == highest || Sched_RunsBefore(taskIndex, highest))
+            {
+                highest = taskIndex;
+            }
+        }
+    }
+    return highest;
+}
+
+/**
+ * @brief Pends a context switch if the thread that owns the core is no longer the highest ready one
+ *        (called with the interrupts disabled)
+ * 
+ */
+static void Sched_Reschedule(void)
+{
+    if(Sched_HighestReady() != Sched_running)
+    {
+        SCHED_PEND_SWITCH();
+    }
+}
+
+/**
+ * @brief Releases a run of a task (called with the interrupts disabled)
+ * 
+ * @param taskIndex The index of the task
+ */
+static void Sched_ReleaseTask(uint8_t taskIndex)
+{
+    if(0xFF == Sched_task[taskIndex].pendingRuns)
+    {
+        Sched_tickStats.droppedRuns++;
+    }
+    else
+    {
+        Sched_task[taskIndex].pendingRuns++;
+    }
+    Sched_readyMask[taskIndex / 32] |= (uint32_t)1 << (taskIndex % 32);
+}
+
+/**
+ * @brief Releases the tasks that are due on this tick and preempts the running one if needed
+ * 
+ */
+static void Sched_TickHandler(void)
+{
+    uint8_t taskIndex;
+    Sched_tickCount++;
+    while(SCHED_NO_TASK != Sched_dueHead && 0 == Sched_task[Sched_dueHead].remainToExec)
+    {
+        taskIndex = Sched_dueHead;
+        Sched_dueHead = Sched_task[taskIndex].next;
+        Sched_task[taskIndex].remainToExec = Sched_task[taskIndex].periodTicks;
+        Sched_ReleaseTask(taskIndex);
+        Sched_InsertTask(taskIndex);
+    }
+    if(SCHED_NO_TASK != Sched_dueHead)
+    {
+        Sched_task[Sched_dueHead].remainToExec--;
+    }
+    Sched_Reschedule();
+}
+
+/**
+ * @brief The thread of a task, it runs the task once for every release
+ * 
+ * @param taskIndex The index of the task
+ */
+static void Sched_TaskThread(uint32_t taskIndex)
+{
+    while(1)
+    {
+        Sched_RunTask(taskIndex);
+        SCHED_DISABLE_INTERRUPTS();
+        /* A deleted task has no runs left */
+        if(Sched_task[taskIndex].pendingRuns)
+        {
+            Sched_task[taskIndex].pendingRuns--;
+        }
+        if(0 == Sched_task[taskIndex].pendingRuns)
+        {
+            Sched_readyMask[taskIndex / 32] &= ~((uint32_t)1 << (taskIndex % 32));
+        }
+        Sched_Reschedule();
+        /* The switch happens here if another thread should run */
+        SCHED_ENABLE_INTERRUPTS();
+    }
+}
+
+/**
+ * @brief Builds the first context of a task thread on its stack
+ * 
+ * @param taskIndex The index of the task
+ */
+static void Sched_InitStack(uint8_t taskIndex)
+{
+    uint32_t* sp = &Sched_stack[taskIndex][(SCHED_TASK_STACK_SIZE / 4) - SCHED_STACK_FRAME_WORDS];
+    uint8_t i;
+    for(i=0; i<SCHED_STACK_FRAME_WORDS; i++)
+    {
+        sp[i] = 0;
+    }
+    sp[SCHED_STACK_FRAME_R0] = taskIndex;
+    /* The thread never returns */
+    sp[SCHED_STACK_FRAME_LR] = 0;
+    /* The exception return loads the pc as is, the thumb state comes from the xpsr */
+    sp[SCHED_STACK_FRAME_PC] = ((uint32_t)Sched_TaskThread) & ~1u;
+    sp[SCHED_STACK_FRAME_XPSR] = SCHED_INITIAL_XPSR;
+    Sched_stackPointer[taskIndex] = sp;
+}
+
+/**
+ * @brief Saves the stack of the thread that owned the core and picks the next one
+ *        (called by the PendSV handler)
+ * 
+ * @param sp The stack pointer of the thread that owned the core
+ * @return uint32_t* The stack pointer of the thread to run
+ */
+__attribute__((used)) static uint32_t* Sched_SwitchContext(uint32_t* sp)
+{
+    Sched_stackPointer[Sched_running] = sp;
+    Sched_running = Sched_HighestReady();
+    if(SCHED_IDLE_THREAD != Sched_running)
+    {
+        Sched_taskItr = Sched_running;
+    }
+    return Sched_stackPointer[Sched_running];
+}
+
+/**
+ * @brief The thread that runs when no task is ready
+ * 
+ */
+__attribute__((noinline)) static void Sched_IdleThread(void)
+{
+#if SCHED_SOFTWARE_TIMERS == STD_ON
+    uint32_t timerUS;
+#endif
+    while(1)
+    {
+#if SCHED_SOFTWARE_TIMERS == STD_ON
+        Timer_Poll();
+        /* Waking up on the next tick would make a near timer late so keep polling it */
+        if(E_OK == Timer_GetNextExpiry(&timerUS) && timerUS < SCHED_TICK_US)
+        {
+            continue;
+        }
+#endif
+        SCHED_WAIT_FOR_INTERRUPT();
+    }
+}
+
+/**
+ * @brief Switches the context to the highest priority ready thread
+ * 
+ */
+void PendSV_Handler(void) __attribute__((naked));
+void PendSV_Handler(void)
+{
+    __asm volatile
+    (
+        "cpsid i                    \n\t"
+        "mrs r0, psp                \n\t"
+        "stmdb r0!, {r4-r11}        \n\t"
+        "push {r3, lr}              \n\t"
+        "bl Sched_SwitchContext     \n\t"
+        "pop {r3, lr}               \n\t"
+        "ldmia r0!, {r4-r11}        \n\t"
+        "msr psp, r0                \n\t"
+        "cpsie i                    \n\t"
+        "bx lr                      \n\t"
+    );
+}
+#endif
+
+/**
+ * @brief Fills a task slot and puts the task in the due list
+ * 
+ * @param taskIndex The index of the slot
+ * @param taskInfo The task information
+ */
+static void Sched_SetupTask(uint8_t taskIndex, const sysTaskInfo_t* taskInfo)
+{
+    Sched_task[taskIndex].taskInfo = taskInfo;
+    Sched_task[taskIndex].remainToExec = taskInfo->delayTicks;
+    Sched_task[taskIndex].periodTicks = taskInfo->task->periodicTimeMS / SCHED_TICK_TIME_MS;
+    if(0 == Sched_task[taskIndex].periodTicks && 0 != taskInfo->task->periodicTimeMS)
+    {
+        Sched_task[taskIndex].periodTicks = 1;
+    }
+#if SCHED_PRIORITY_ORDER == SCHED_PRIORITY_RATE_MONOTONIC
+    Sched_task[taskIndex].priorityKey = Sched_task[taskIndex].periodTicks;
+#elif SCHED_PRIORITY_ORDER == SCHED_PRIORITY_EXPLICIT
+    Sched_task[taskIndex].priorityKey = taskInfo->priority;
+#else
+    Sched_task[taskIndex].priorityKey = 0;
+#endif
+    Sched_task[taskIndex].state = SCHED_TASK_RUNNING;
+#if SCHED_TASK_STATS == STD_ON
+    Sched_task[taskIndex].lastCycles = 0;
+    Sched_task[taskIndex].minCycles = 0xFFFFFFFF;
+    Sched_task[taskIndex].maxCycles = 0;
+    Sched_task[taskIndex].totalCycles = 0;
+    Sched_task[taskIndex].activations = 0;
+    Sched_task[taskIndex].overruns = 0;
+#endif
+#if SCHED_MODE == SCHED_MODE_PREEMPTIVE
+    Sched_task[taskIndex].pendingRuns = 0;
+    Sched_InitStack(taskIndex);
+#endif
+    /* Event activated tasks only run when Sched_ActivateTask is called */
+    if(0 != Sched_task[taskIndex].periodTicks)
+    {
+        Sched_InsertTask(taskIndex);
+    }
+}
+
+#if SCHED_MODE == SCHED_MODE_COOPERATIVE
+
+/**
+ * @brief Runs the tasks that are due on this tick
+ * 
+ * @param dropLowPriority Skip the runs of the low priority tasks (STD_ON/STD_OFF)
+ */
+static void Sched_Tick(uint8_t dropLowPriority)
+{
+    while(SCHED_NO_TASK != Sched_dueHead && 0 == Sched_task[Sched_dueHead].remainToExec)
+    {
+        Sched_taskItr = Sched_dueHead;
+        Sched_dueHead = Sched_task[Sched_taskItr].next;
+        /* The task may add to this with Sched_Sleep while running */
+        Sched_task[Sched_taskItr].remainToExec = Sched_task[Sched_taskItr].periodTicks;
+        Sched_dueRun = 1;
+#if SCHED_CATCHUP_POLICY == SCHED_CATCHUP_DROP_LOW_PRIORITY
+        if(STD_ON == dropLowPriority && Sched_task[Sched_taskItr].periodTicks >= SCHED_DROP_PERIOD_TICKS)
+        {
+            Sched_tickStats.droppedRuns++;
+        }
+        else
+        {
+            Sched_RunTask(Sched_taskItr);
+        }
+#else
+        (void)dropLowPriority;
+        Sched_RunTask(Sched_taskItr);
+#endif
+        Sched_dueRun = 0;
+        if(SCHED_TASK_RUNNING == Sched_task[Sched_taskItr].state)
+        {
+            Sched_InsertTask(Sched_taskItr);
+        }
+    }
+    if(SCHED_NO_TASK != Sched_dueHead)
+    {
+        Sched_task[Sched_dueHead].remainToExec--;
+    }
+}
+
+/**
+ * @brief Accounts for the ticks that passed without a scheduler pass
+ * 
+ * @param ticks The number of skipped ticks
+ */
+static void Sched_SkipTicks(uint32_t ticks)
+{
+    uint8_t curr = Sched_dueHead;
+    /* Tasks that should have run during the skipped ticks become due now */
+    while(SCHED_NO_TASK != curr && ticks > 0)
+    {
+        if(Sched_task[curr].remainToExec >= ticks)
+        {
+            Sched_task[curr].remainToExec -= ticks;
+            ticks = 0;
+        }
+        else
+        {
+            ticks -= Sched_task[curr].remainToExec;
+            Sched_task[curr].remainToExec = 0;
+        }
+        curr = Sched_task[curr].next;
+    }
+}
+
+/**
+ * @brief Runs the scheduler passes for the pending ticks using the catch up policy
+ * 
+ * @param ticks The number of pending ticks
+ */
+static void Sched_CatchUp(uint32_t ticks)
+{
+    if(ticks > 1)
+    {
+        /* The tasks of the previous ticks ran past this tick */
+        Sched_tickStats.lostTicks += ticks - 1;
+    }
+    if(ticks > Sched_tickStats.maxBacklog)
+    {
+        Sched_tickStats.maxBacklog = ticks;
+    }
+#if SCHED_CATCHUP_POLICY == SCHED_CATCHUP_SKIP
+    /* Keep the time base, the tasks due in the lost ticks run once */
+    Sched_SkipTicks(ticks - 1);
+    Sched_Tick(STD_OFF);
+#else
+    while(ticks > 1)
+    {
+        Sched_Tick(SCHED_CATCHUP_POLICY == SCHED_CATCHUP_DROP_LOW_PRIORITY ? STD_ON : STD_OFF);
+        ticks--;
+    }
+    Sched_Tick(STD_OFF);
+#endif
+}
+
+/**
+ * @brief Runs the tasks activated since the last call
+ * 
+ */
+static void Sched_RunActivated(void)
+{
+    uint8_t word;
+    uint32_t ready;
+    Sched_activated = 0;
+    for(word=0; word<SCHED_READY_WORDS; word++)
+    {
+        SCHED_DISABLE_INTERRUPTS();
+        ready = Sched_readyMask[word];
+        Sched_readyMask[word] = 0;
+        SCHED_ENABLE_INTERRUPTS();
+        while(ready)
+        {
+            Sched_taskItr = (word * 32) + __builtin_ctz(ready);
+            /* Clear the lowest set bit */
+            ready &= ready - 1;
+            if(SCHED_TASK_RUNNING == Sched_task[Sched_taskItr].state)
+            {
+                Sched_RunTask(Sched_taskItr);
+            }
+        }
+    }
+}
+
+#if SCHED_TICKLESS_IDLE == STD_ON
+/**
+ * @brief Sleeps until the next interrupt, stretching the next SysTick period
+ *        to the nearest due task so that the idle ticks cost no wakeups
+ * 
+ */
+static void Sched_Idle(void)
+{
+    uint32_t idleTicks = SCHED_MAX_IDLE_TICKS;
+    uint32_t counts;
+    uint8_t pending;
+#if SCHED_SOFTWARE_TIMERS == STD_ON
+    uint32_t timerUS;
+    uint8_t timerNear = 0;
+#endif
+    Sched_deadlineMoved = 0;
+    /* The nearest due task is the head of the due list */
+    if(SCHED_NO_TASK != Sched_dueHead && Sched_task[Sched_dueHead].remainToExec < idleTicks)
+    {
+        idleTicks = Sched_task[Sched_dueHead].remainToExec;
+    }
+#if SCHED_SOFTWARE_TIMERS == STD_ON
+    if(E_OK == Timer_GetNextExpiry(&timerUS))
+    {
+        if(timerUS < SCHED_TICK_US)
+        {
+            /* Waking up on the next tick would make the timer late so keep polling it */
+            timerNear = 1;
+        }
+        else if(timerUS / SCHED_TICK_US - 1 < idleTicks)
+        {
+            /* The stretched period starts after the rest of the current tick */
+            idleTicks = timerUS / SCHED_TICK_US - 1;
+        }
+    }
+#endif
+    SCHED_DISABLE_INTERRUPTS();
+#if SCHED_SOFTWARE_TIMERS == STD_ON
+    if(0 == Sched_pendingTicks && 0 == Sched_activated && 0 == Sched_deadlineMoved && 0 == timerNear)
+#else
+    if(0 == Sched_pendingTicks && 0 == Sched_activated && 0 == Sched_deadlineMoved)
+#endif
+    {
+        /* The reload value is only taken by the counter at the next tick,
+           so the current tick keeps its length and no time is lost */
+        if(idleTicks > 0 && 1 == Sched_countingTicks && 1 == Sched_reloadTicks)
+        {
+            SysTick_GetValue(&counts);
+            SysTick_IsPending(&pending);
+            if(SYSTICK_NOT_PENDING == pending && counts > SCHED_IDLE_GUARD_COUNTS)
+            {
+                SysTick_SetReloadValue(idleTicks * SCHED_TICK_COUNTS);
+                Sched_reloadTicks = idleTicks;
+            }
+        }
+        /* A pending interrupt still wakes the core up while they are disabled */
+        SCHED_WAIT_FOR_INTERRUPT();
+    }
+    SCHED_ENABLE_INTERRUPTS();
+}
+
+/**
+ * @brief Ends a stretched SysTick period on the next tick when a new deadline comes before its end,
+ *        the next Sched_Idle stretches it again from the new due list and timers
+ *        (called with the interrupts disabled)
+ * 
+ * @param ticks The whole ticks from now to the new deadline
+ */
+static void Sched_CutIdle(uint32_t ticks)
+{
+    volatile uint32_t* periodTicks = &Sched_countingTicks;
+    uint32_t counts;
+    uint32_t remainCounts;
+    uint8_t pending;
+    /* The counter stands still so it cannot reload while it is read and reprogrammed,
+       the few counts this takes are lost from the time base */
+    SysTick_Stop();
+    SysTick_GetValue(&counts);
+    SysTick_IsPending(&pending);
+    if(SYSTICK_PENDING == pending)
+    {
+        /* The counter has taken the reload value already, Sched_SetFlag makes it the counting ticks */
+        periodTicks = &Sched_reloadTicks;
+    }
+    else if(1 != Sched_reloadTicks && ticks <= Sched_reloadTicks)
+    {
+        /* The stretch is only loaded, the counter takes the normal tick instead */
+        SysTick_SetReloadValue(SCHED_TICK_COUNTS);
+        Sched_reloadTicks = 1;
+    }
+    /* Keep the tick that is counting and drop the whole ticks after it if the period ends after the deadline */
+    remainCounts = counts % SCHED_TICK_COUNTS;
+    if(remainCounts < SCHED_IDLE_GUARD_COUNTS)
+    {
+        remainCounts += SCHED_TICK_COUNTS;
+    }
+    if(*periodTicks > 1 && counts > remainCounts && ticks < SCHED_MAX_IDLE_TICKS && ticks * SCHED_TICK_COUNTS < counts)
+    {
+        *periodTicks -= (counts - remainCounts) / SCHED_TICK_COUNTS;
+        SysTick_SetReloadValue(remainCounts);
+        SysTick_ClearValue();
+        SysTick_Start();
+        /* The counter loads the short period on its first clock, the period after it is a normal tick */
+        do
+        {
+            SysTick_GetValue(&counts);
+        } while(0 == counts);
+        SysTick_SetReloadValue(SCHED_TICK_COUNTS);
+    }
+    else
+    {
+        SysTick_Start();
+    }
 }
+#endif
+#endif
 
 /**
  * @brief The scheduler that will run all the time
@@ -51,26 +790,51 @@ static void Sched_SetFlag(void)
  */
 void Sched_Start(void)
 {
+#if SCHED_MODE == SCHED_MODE_PREEMPTIVE
+    /* The caller becomes the idle thread running on the process stack,
+       it keeps no locals on the main stack after the switch */
+    SCHED_SET_PSP(&Sched_idleStack[SCHED_IDLE_STACK_SIZE / 4]);
+    SCHED_USE_PSP();
+    SysTick_Start();
+    Sched_IdleThread();
+#else
+    uint32_t pendingTicks;
+#if SCHED_TICKLESS_IDLE == STD_ON
+    uint32_t idleTicks;
+#endif
     SysTick_Start();
     while(1)
     {
-        if(Sched_flag)
+        if(Sched_pendingTicks)
         {
-            Sched_flag = 0;
-            for(Sched_taskItr=0; Sched_taskItr<SCHED_NUMBER_OF_TASKS; Sched_taskItr++)
-            {
-                if(SCHED_TASK_RUNNING == Sched_task[Sched_taskItr].state)
-                {
-                        if(0 == Sched_task[Sched_taskItr].remainToExec)
-                        {
-                            Sched_task[Sched_taskItr].remainToExec = Sched_task[Sched_taskItr].periodTicks;
-                            Sched_task[Sched_taskItr].taskInfo->task->runnable();
-                        }
-                        Sched_task[Sched_taskItr].remainToExec--;
-                }
-            }
+            SCHED_DISABLE_INTERRUPTS();
+            pendingTicks = Sched_pendingTicks;
+            Sched_pendingTicks = 0;
+#if SCHED_TICKLESS_IDLE == STD_ON
+            idleTicks = Sched_idleTicks;
+            Sched_idleTicks = 0;
+#endif
+            SCHED_ENABLE_INTERRUPTS();
+#if SCHED_TICKLESS_IDLE == STD_ON
+            Sched_SkipTicks(idleTicks);
+#endif
+            Sched_CatchUp(pendingTicks);
+        }
+        if(Sched_activated)
+        {
+            Sched_RunActivated();
         }
+#if SCHED_SOFTWARE_TIMERS == STD_ON
+        Timer_Poll();
+#endif
+#if SCHED_TICKLESS_IDLE == STD_ON
+        if(0 == Sched_pendingTicks && 0 == Sched_activated)
+        {
+            Sched_Idle();
+        }
+#endif
     }
+#endif
 }
 
 /**
@@ -81,16 +845,40 @@ void Sched_Start(void)
 Std_ReturnType Sched_Init(void)
 {
     uint8_t i;
+    Sched_dueHead = SCHED_NO_TASK;
+    Sched_tickStats.lostTicks = 0;
+    Sched_tickStats.maxBacklog = 0;
+    Sched_tickStats.droppedRuns = 0;
+    Sched_tickCount = 0;
     for(i=0; i<SCHED_NUMBER_OF_TASKS; i++)
     {
-        Sched_task[i].taskInfo = &Sched_sysTaskInfo[i];
-        Sched_task[i].remainToExec = Sched_task[i].taskInfo->delayTicks;
-        Sched_task[i].periodTicks = Sched_task[i].taskInfo->task->periodicTimeMS / SCHED_TICK_TIME_MS;
-        Sched_task[i].state = SCHED_TASK_RUNNING;
+        Sched_SetupTask(i, &Sched_sysTaskInfo[i]);
     }
+    for(; i<SCHED_MAX_NUMBER_OF_TASKS; i++)
+    {
+        Sched_task[i].state = SCHED_TASK_FREE;
+    }
+    for(i=0; i<SCHED_READY_WORDS; i++)
+    {
+        Sched_readyMask[i] = 0;
+    }
+    Sched_activated = 0;
+#if SCHED_TASK_STATS == STD_ON
+    Dwt_Init();
+#endif
+#if SCHED_SOFTWARE_TIMERS == STD_ON
+    Timer_Init();
+#endif
     SysTick_Stop();
     SysTick_SetTimeUS(SCHED_AHB_CLK, SCHED_TICK_TIME_MS*1000);
+#if SCHED_MODE == SCHED_MODE_PREEMPTIVE
+    Sched_running = SCHED_IDLE_THREAD;
+    /* The context switch must never preempt the tick or any other interrupt */
+    SCHED_SHPR3 = (SCHED_SHPR3 & SCHED_SHPR3_CLR_MASK) | SCHED_SHPR3_PRIORITIES;
+    SysTick_SetCallBack(Sched_TickHandler);
+#else
     SysTick_SetCallBack(Sched_SetFlag);
+#endif
     SysTick_ClearValue();
     SysTick_InterruptEnable();
     return E_OK;
@@ -106,12 +894,144 @@ Std_ReturnType Sched_Init(void)
  */
 Std_ReturnType Sched_SuspendTask(void)
 {
-    Sched_task[Sched_taskItr].state = SCHED_TASK_SUSPENDED;
-    return E_OK;
+    return Sched_SuspendTaskById(Sched_taskItr);
+}
+
+/**
+ * @brief Creates a task in a free slot of the task pool
+ * 
+ * @param taskInfo The task information, it must stay valid until the task is deleted
+ * @param taskIndex A pointer to return the index of the created task in
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+Std_ReturnType Sched_CreateTask(const sysTaskInfo_t* taskInfo, uint8_t* taskIndex)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t primask;
+    uint8_t i;
+    if(taskInfo && taskInfo->task && taskInfo->task->runnable && taskIndex)
+    {
+        /* The due list is also used by the tick interrupt in the preemptive mode */
+        CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+        for(i=SCHED_NUMBER_OF_TASKS; i<SCHED_MAX_NUMBER_OF_TASKS; i++)
+        {
+#if SCHED_MODE == SCHED_MODE_PREEMPTIVE
+            /* A task that deleted itself still runs on its stack */
+            if(SCHED_TASK_FREE == Sched_task[i].state && i != Sched_running)
+#else
+            if(SCHED_TASK_FREE == Sched_task[i].state)
+#endif
+            {
+                Sched_SetupTask(i, taskInfo);
+                /* The delay counts from the last scheduler pass which a stretched period may be past */
+                Sched_NewDeadline(0);
+                *taskIndex = i;
+                error = E_OK;
+                break;
+            }
+        }
+        CRITICAL_RESTORE_INTERRUPTS(primask);
+    }
+    return error;
 }
 
 /**
- * @brief Makes a task sleep for a while
+ * @brief Deletes a task and frees its slot in the task pool
+ * 
+ * @param taskIndex The index of the task
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+Std_ReturnType Sched_DeleteTask(uint8_t taskIndex)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t primask;
+    CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+    if(taskIndex < SCHED_MAX_NUMBER_OF_TASKS && SCHED_TASK_FREE != Sched_task[taskIndex].state)
+    {
+        /* A task deleting itself is already out of the due list and is not put back */
+        Sched_RemoveTask(taskIndex);
+        Sched_readyMask[taskIndex / 32] &= ~((uint32_t)1 << (taskIndex % 32));
+        Sched_task[taskIndex].state = SCHED_TASK_FREE;
+#if SCHED_MODE == SCHED_MODE_PREEMPTIVE
+        Sched_task[taskIndex].pendingRuns = 0;
+        Sched_Reschedule();
+#endif
+        error = E_OK;
+    }
+    CRITICAL_RESTORE_INTERRUPTS(primask);
+    return error;
+}
+
+/**
+ * @brief Suspends a task
+ * 
+ * @param taskIndex The index of the task
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+Std_ReturnType Sched_SuspendTaskById(uint8_t taskIndex)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t primask;
+    CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+    if(taskIndex < SCHED_MAX_NUMBER_OF_TASKS && SCHED_TASK_RUNNING == Sched_task[taskIndex].state)
+    {
+        Sched_RemoveTask(taskIndex);
+        Sched_task[taskIndex].state = SCHED_TASK_SUSPENDED;
+#if SCHED_MODE == SCHED_MODE_PREEMPTIVE
+        /* The task stops at once and carries on from there when resumed */
+        Sched_readyMask[taskIndex / 32] &= ~((uint32_t)1 << (taskIndex % 32));
+        Sched_Reschedule();
+#endif
+        error = E_OK;
+    }
+    CRITICAL_RESTORE_INTERRUPTS(primask);
+    return error;
+}
+
+/**
+ * @brief Resumes a suspended task, a periodic task becomes due on the next scheduler pass
+ * 
+ * @param taskIndex The index of the task
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+Std_ReturnType Sched_ResumeTask(uint8_t taskIndex)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t primask;
+    CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+    if(taskIndex < SCHED_MAX_NUMBER_OF_TASKS && SCHED_TASK_SUSPENDED == Sched_task[taskIndex].state)
+    {
+        Sched_task[taskIndex].state = SCHED_TASK_RUNNING;
+        if(0 != Sched_task[taskIndex].periodTicks)
+        {
+            Sched_task[taskIndex].remainToExec = 0;
+            Sched_InsertTask(taskIndex);
+            Sched_NewDeadline(0);
+        }
+#if SCHED_MODE == SCHED_MODE_PREEMPTIVE
+        if(Sched_task[taskIndex].pendingRuns)
+        {
+            Sched_readyMask[taskIndex / 32] |= (uint32_t)1 << (taskIndex % 32);
+            Sched_Reschedule();
+        }
+#endif
+        error = E_OK;
+    }
+    CRITICAL_RESTORE_INTERRUPTS(primask);
+    return error;
+}
+
+/**
+ * @brief Makes the running periodic task sleep for a while
+ *        (refused for the event activated tasks and the runs started by Sched_ActivateTask)
  * 
  * @param timeMS The sleep time in milli seconds
  * @return Std_ReturnType 
@@ -120,7 +1040,193 @@ Std_ReturnType Sched_SuspendTask(void)
  */
 Std_ReturnType Sched_Sleep(uint32_t timeMS)
 {
+    Std_ReturnType error = E_NOT_OK;
     uint32_t times = timeMS / SCHED_TICK_TIME_MS;
-    Sched_task[Sched_taskItr].remainToExec += times;
-    return E_OK;
+#if SCHED_MODE == SCHED_MODE_PREEMPTIVE
+    uint32_t primask;
+    uint8_t curr;
+    CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+    /* The task was put back in the due list when it was released, move it further */
+    curr = Sched_dueHead;
+    while(SCHED_NO_TASK != curr && Sched_taskItr != curr)
+    {
+        times += Sched_task[curr].remainToExec;
+        curr = Sched_task[curr].next;
+    }
+    if(SCHED_NO_TASK != curr)
+    {
+        times += Sched_task[curr].remainToExec;
+        Sched_RemoveTask(curr);
+        Sched_task[curr].remainToExec = times;
+        Sched_InsertTask(curr);
+        error = E_OK;
+    }
+    CRITICAL_RESTORE_INTERRUPTS(primask);
+#else
+    /* Only a run from the due list has the task unlinked with its next period in remainToExec,
+       a linked task holds a delta that the tasks after it depend on */
+    if(1 == Sched_dueRun && 0 != Sched_task[Sched_taskItr].periodTicks)
+    {
+        Sched_task[Sched_taskItr].remainToExec += times;
+        error = E_OK;
+    }
+#endif
+    return error;
 }
+
+/**
+ * @brief Activates a task so that it runs once on the next scheduler pass
+ *        (safe to call from an interrupt, a free or suspended task is refused)
+ * 
+ * @param taskIndex The index of the task
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+Std_ReturnType Sched_ActivateTask(uint8_t taskIndex)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t primask;
+    CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+    /* A free slot has no stack and a suspended task waits for Sched_ResumeTask */
+    if(taskIndex < SCHED_MAX_NUMBER_OF_TASKS && SCHED_TASK_RUNNING == Sched_task[taskIndex].state)
+    {
+#if SCHED_MODE == SCHED_MODE_PREEMPTIVE
+        Sched_ReleaseTask(taskIndex);
+        Sched_Reschedule();
+#else
+        Sched_readyMask[taskIndex / 32] |= (uint32_t)1 << (taskIndex % 32);
+        Sched_activated = 1;
+        /* The pass after the run stretches the idle period again from what the task changed */
+        Sched_NewDeadline(0);
+#endif
+        error = E_OK;
+    }
+    CRITICAL_RESTORE_INTERRUPTS(primask);
+    return error;
+}
+
+/**
+ * @brief Gets the execution time statistics of a task
+ * 
+ * @param taskIndex The index of the task
+ * @param stats A pointer to return the statistics in
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+Std_ReturnType Sched_GetTaskStats(uint8_t taskIndex, schedTaskStats_t* stats)
+{
+    Std_ReturnType error = E_NOT_OK;
+#if SCHED_TASK_STATS == STD_ON
+    if(taskIndex < SCHED_MAX_NUMBER_OF_TASKS && stats)
+    {
+        stats->lastCycles = Sched_task[taskIndex].lastCycles;
+        stats->minCycles = Sched_task[taskIndex].activations ? Sched_task[taskIndex].minCycles : 0;
+        stats->maxCycles = Sched_task[taskIndex].maxCycles;
+        stats->meanCycles = Sched_task[taskIndex].activations ? (uint32_t)(Sched_task[taskIndex].totalCycles / Sched_task[taskIndex].activations) : 0;
+        stats->activations = Sched_task[taskIndex].activations;
+        stats->overruns = Sched_task[taskIndex].overruns;
+        error = E_OK;
+    }
+#else
+    (void)taskIndex;
+    (void)stats;
+#endif
+    return error;
+}
+
+/**
+ * @brief Gets the statistics of the ticks that were lost due to overload
+ * 
+ * @param stats A pointer to return the statistics in
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+Std_ReturnType Sched_GetTickStats(schedTickStats_t* stats)
+{
+    Std_ReturnType error = E_NOT_OK;
+    if(stats)
+    {
+        *stats = Sched_tickStats;
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Gets the time since the scheduler started in micro seconds (wraps around)
+ * 
+ * @param timeUS A pointer to return the time in
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+Std_ReturnType Sched_GetTimeUS(uint32_t* timeUS)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t primask;
+    uint32_t ticks;
+    uint32_t periodCounts;
+    uint32_t counts;
+    uint8_t pending;
+    if(timeUS)
+    {
+        CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+        ticks = Sched_tickCount;
+#if SCHED_TICKLESS_IDLE == STD_ON
+        periodCounts = Sched_countingTicks * SCHED_TICK_COUNTS;
+#else
+        periodCounts = SCHED_TICK_COUNTS;
+#endif
+        SysTick_GetValue(&counts);
+        SysTick_IsPending(&pending);
+        if(SYSTICK_PENDING == pending)
+        {
+            /* The period ended but its interrupt did not run yet, the counter has reloaded */
+            SysTick_GetValue(&counts);
+            ticks += periodCounts / SCHED_TICK_COUNTS;
+#if SCHED_TICKLESS_IDLE == STD_ON
+            periodCounts = Sched_reloadTicks * SCHED_TICK_COUNTS;
+#endif
+        }
+        CRITICAL_RESTORE_INTERRUPTS(primask);
+        /* The counter counts down from the period */
+        counts = periodCounts - counts;
+#if (SCHED_AHB_CLK % 1000000) == 0
+        *timeUS = (ticks * SCHED_TICK_US) + (counts / (SCHED_AHB_CLK / 1000000));
+#else
+        *timeUS = (ticks * SCHED_TICK_US) + (uint32_t)(((uint64_t)counts * 1000000) / SCHED_AHB_CLK);
+#endif
+        error = E_OK;
+    }
+    return error;
+}
+
+/**
+ * @brief Tells the scheduler about a new deadline so that a stretched idle period does not sleep past it
+ *        (safe to call from an interrupt)
+ * 
+ * @param timeUS The time from now to the deadline in micro seconds (0 for the next tick)
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+Std_ReturnType Sched_NewDeadline(uint32_t timeUS)
+{
+#if SCHED_TICKLESS_IDLE == STD_ON
+    uint32_t primask;
+    CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+    /* Sched_Idle may be working out a stretch from the old deadlines */
+    Sched_deadlineMoved = 1;
+    if(1 != Sched_countingTicks || 1 != Sched_reloadTicks)
+    {
+        Sched_CutIdle(timeUS / SCHED_TICK_US);
+    }
+    CRITICAL_RESTORE_INTERRUPTS(primask);
+#else
+    (void)timeUS;
+#endif
+    return E_OK;
+}
\ No newline at end of file
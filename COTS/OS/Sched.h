@@ -11,6 +11,29 @@
 #ifndef SCHED_H
 #define SCHED_H
 
+/**
+ * @brief The catch up policies for the ticks that pass while the tasks are still running
+ * 
+ */
+#define SCHED_CATCHUP_RUN_BACKLOG               0   /* Run a scheduler pass for every lost tick */
+#define SCHED_CATCHUP_SKIP                      1   /* Run one pass, the tasks due in the lost ticks run once */
+#define SCHED_CATCHUP_DROP_LOW_PRIORITY         2   /* Run the backlog without the long period tasks */
+
+/**
+ * @brief The scheduler backends
+ * 
+ */
+#define SCHED_MODE_COOPERATIVE                  0   /* The tasks run to completion one after the other from Sched_Start */
+#define SCHED_MODE_PREEMPTIVE                   1   /* Every task has its own stack and a higher priority task preempts a lower one */
+
+/**
+ * @brief The priority orders of the tasks due on the same tick
+ * 
+ */
+#define SCHED_PRIORITY_INDEX                    0   /* The configuration order */
+#define SCHED_PRIORITY_RATE_MONOTONIC           1   /* The shorter periodic time first */
+#define SCHED_PRIORITY_EXPLICIT                 2   /* The lower priority field of sysTaskInfo_t first */
+
 typedef void (*taskRunnable_t)(void);
 
 /**
@@ -20,7 +43,7 @@ typedef void (*taskRunnable_t)(void);
 typedef struct
 {
     taskRunnable_t runnable;    /* The task runnable */
-    uint32_t periodicTimeMS;    /* The periodic time in milli seconds*/
+    uint32_t periodicTimeMS;    /* The periodic time in milli seconds (0 for a task run by Sched_ActivateTask only) */
 
 }task_t;
 
@@ -32,8 +55,34 @@ typedef struct
 {
     const task_t* task;         /* The task */
     uint32_t delayTicks;        /* The first delay in ticks */
+    uint8_t priority;           /* The priority, 0 is the highest (SCHED_PRIORITY_EXPLICIT) */
 } sysTaskInfo_t;
 
+/**
+ * @brief The execution time statistics of a task in core cycles
+ * 
+ */
+typedef struct
+{
+    uint32_t lastCycles;        /* The execution time of the last run */
+    uint32_t minCycles;         /* The shortest execution time */
+    uint32_t maxCycles;         /* The longest execution time */
+    uint32_t meanCycles;        /* The mean execution time */
+    uint32_t activations;       /* The number of runs */
+    uint32_t overruns;          /* The number of runs longer than a tick */
+} schedTaskStats_t;
+
+/**
+ * @brief The statistics of the ticks lost due to overload
+ * 
+ */
+typedef struct
+{
+    uint32_t lostTicks;         /* The ticks that passed while the tasks of a previous tick were running */
+    uint32_t maxBacklog;        /* The most ticks handled at once */
+    uint32_t droppedRuns;       /* The task runs dropped while catching up */
+} schedTickStats_t;
+
 /**
  * @brief The scheduler that will run all the time
  * 
@@ -57,7 +106,49 @@ extern Std_ReturnType Sched_Init(void);
 extern Std_ReturnType Sched_SuspendTask(void);
 
 /**
- * @brief Makes a task sleep for a while
+ * @brief Creates a task in a free slot of the task pool
+ * 
+ * @param taskInfo The task information, it must stay valid until the task is deleted
+ * @param taskIndex A pointer to return the index of the created task in
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+extern Std_ReturnType Sched_CreateTask(const sysTaskInfo_t* taskInfo, uint8_t* taskIndex);
+
+/**
+ * @brief Deletes a task and frees its slot in the task pool
+ * 
+ * @param taskIndex The index of the task
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+extern Std_ReturnType Sched_DeleteTask(uint8_t taskIndex);
+
+/**
+ * @brief Suspends a task
+ * 
+ * @param taskIndex The index of the task
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+extern Std_ReturnType Sched_SuspendTaskById(uint8_t taskIndex);
+
+/**
+ * @brief Resumes a suspended task, a periodic task becomes due on the next scheduler pass
+ * 
+ * @param taskIndex The index of the task
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+extern Std_ReturnType Sched_ResumeTask(uint8_t taskIndex);
+
+/**
+ * @brief Makes the running periodic task sleep for a while
+ *        (refused for the event activated tasks and the runs started by Sched_ActivateTask)
  * 
  * @param timeMS The sleep time in milli seconds
  * @return Std_ReturnType 
@@ -66,4 +157,57 @@ extern Std_ReturnType Sched_SuspendTask(void);
  */
 extern Std_ReturnType Sched_Sleep(uint32_t timeMS);
 
+/**
+ * @brief Activates a task so that it runs once on the next scheduler pass
+ *        (safe to call from an interrupt, a free or suspended task is refused)
+ * 
+ * @param taskIndex The index of the task
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+extern Std_ReturnType Sched_ActivateTask(uint8_t taskIndex);
+
+/**
+ * @brief Gets the execution time statistics of a task
+ * 
+ * @param taskIndex The index of the task
+ * @param stats A pointer to return the statistics in
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+extern Std_ReturnType Sched_GetTaskStats(uint8_t taskIndex, schedTaskStats_t* stats);
+
+/**
+ * @brief Gets the statistics of the ticks that were lost due to overload
+ * 
+ * @param stats A pointer to return the statistics in
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+extern Std_ReturnType Sched_GetTickStats(schedTickStats_t* stats);
+
+/**
+ * @brief Gets the time since the scheduler started in micro seconds (wraps around)
+ * 
+ * @param timeUS A pointer to return the time in
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+extern Std_ReturnType Sched_GetTimeUS(uint32_t* timeUS);
+
+/**
+ * @brief Tells the scheduler about a new deadline so that a stretched idle period does not sleep past it
+ *        (safe to call from an interrupt)
+ * 
+ * @param timeUS The time from now to the deadline in micro seconds (0 for the next tick)
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+extern Std_ReturnType Sched_NewDeadline(uint32_t timeUS);
+
 #endif
\ No newline at end of file
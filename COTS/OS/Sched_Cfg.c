@@ -18,6 +18,6 @@ extern const task_t Switch_task;
 
 const sysTaskInfo_t Sched_sysTaskInfo[SCHED_NUMBER_OF_TASKS] = 
 {
-    {&Switch_task, 0},
-    {&CLcd_task, 1}
+    {&Switch_task, 0, 0},
+    {&CLcd_task, 1, 1}
 };
@@ -13,8 +13,39 @@
 
 #define SCHED_NUMBER_OF_TASKS             2
 
+/* The size of the task pool, the configured tasks and the ones made by Sched_CreateTask */
+#define SCHED_MAX_NUMBER_OF_TASKS         4
+
 #define SCHED_TICK_TIME_MS                1
 
 #define SCHED_AHB_CLK                     1000000
 
+#define SCHED_CPU_CLK                     8000000
+
+/* The scheduler backend SCHED_MODE_COOPERATIVE / SCHED_MODE_PREEMPTIVE */
+#define SCHED_MODE                        SCHED_MODE_COOPERATIVE
+
+/* The order of the tasks due on the same tick and the preemption order
+ * SCHED_PRIORITY_INDEX / SCHED_PRIORITY_RATE_MONOTONIC / SCHED_PRIORITY_EXPLICIT */
+#define SCHED_PRIORITY_ORDER              SCHED_PRIORITY_RATE_MONOTONIC
+
+/* The stack size of every task in bytes (SCHED_MODE_PREEMPTIVE) */
+#define SCHED_TASK_STACK_SIZE             512
+
+/* Measure the execution time of every task with the DWT cycle counter, boards opt in as it enables the DWT (STD_ON/STD_OFF) */
+#define SCHED_TASK_STATS                  STD_OFF
+
+/* What to do with the ticks that pass while the tasks are still running
+ * SCHED_CATCHUP_RUN_BACKLOG / SCHED_CATCHUP_SKIP / SCHED_CATCHUP_DROP_LOW_PRIORITY */
+#define SCHED_CATCHUP_POLICY              SCHED_CATCHUP_RUN_BACKLOG
+
+/* The tasks with this period or longer are dropped while catching up (SCHED_CATCHUP_DROP_LOW_PRIORITY) */
+#define SCHED_CATCHUP_DROP_PERIOD_MS      100
+
+/* Stretch the SysTick period over the idle ticks and sleep, boards opt in as it changes the tick timing (STD_ON/STD_OFF) */
+#define SCHED_TICKLESS_IDLE               STD_OFF
+
+/* Poll the micro second software timers of Timer.h from the scheduler loop, boards opt in (STD_ON/STD_OFF) */
+#define SCHED_SOFTWARE_TIMERS             STD_OFF
+
 #endif
\ No newline at end of file
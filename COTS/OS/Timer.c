@@ -0,0 +1,257 @@
+/**
+ * @file Timer.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This file is the implementation for the Software Timers
+ * @version 0.1
+ * @date 2020-03-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include "Std_Types.h"
+#include "Critical_Cfg.h"
+#include "Critical.h"
+#include "Sched_Cfg.h"
+#include "Sched.h"
+#include "Timer_Cfg.h"
+#include "Timer.h"
+
+#if TIMER_MAX_NUMBER_OF_TIMERS >= TIMER_NO_TIMER
+#error "TIMER_MAX_NUMBER_OF_TIMERS must be less than 255"
+#endif
+
+#define TIMER_ID(slot, generation)       ((uint16_t)(((uint16_t)(generation) << 8) | (slot)))
+#define TIMER_ID_SLOT(timerId)           ((uint8_t)((timerId) & 0xFF))
+#define TIMER_ID_GENERATION(timerId)     ((uint8_t)((timerId) >> 8))
+
+/* The times wrap around so they are compared by their distance */
+#define TIMER_IS_EXPIRED(expiry, now)    ((sint32_t)((now) - (expiry)) >= 0)
+
+/**
+ * @brief A Software Timer
+ *
+ */
+typedef struct
+{
+    uint32_t expiry;        /* The time to expire at in micro seconds */
+    timerCb_t callBack;     /* The function to call when the timer expires, NULL for a free timer */
+    uint8_t next;           /* The next timer in the expiry list */
+    uint8_t generation;     /* Counts the timers the slot ran (wraps around) so a stale id is refused */
+} swTimer_t;
+
+static swTimer_t Timer_timer[TIMER_MAX_NUMBER_OF_TIMERS];
+
+/* The running timers sorted by their expiry time */
+static uint8_t Timer_head = TIMER_NO_TIMER;
+
+/**
+ * @brief Removes a timer from the expiry list if it is there
+ *
+ * @param timerId The slot of the timer
+ */
+static void Timer_Remove(uint8_t timerId)
+{
+    uint8_t prev = TIMER_NO_TIMER;
+    uint8_t curr = Timer_head;
+    while(TIMER_NO_TIMER != curr && timerId != curr)
+    {
+        prev = curr;
+        curr = Timer_timer[curr].next;
+    }
+    if(TIMER_NO_TIMER != curr)
+    {
+        if(TIMER_NO_TIMER == prev)
+        {
+            Timer_head = Timer_timer[curr].next;
+        }
+        else
+        {
+            Timer_timer[prev].next = Timer_timer[curr].next;
+        }
+    }
+}
+
+/**
+ * @brief The initialization for the Software Timers
+ *
+ * @return Std_ReturnType
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+Std_ReturnType Timer_Init(void)
+{
+    uint8_t i;
+    for(i=0; i<TIMER_MAX_NUMBER_OF_TIMERS; i++)
+    {
+        Timer_timer[i].callBack = NULL;
+        Timer_timer[i].next = TIMER_NO_TIMER;
+        Timer_timer[i].generation = 0;
+    }
+    Timer_head = TIMER_NO_TIMER;
+    return E_OK;
+}
+
+/**
+ * @brief Starts a one shot timer
+ *
+ * @param timeUS The time before the callback is called in micro seconds
+ * @param callBack The function to call when the timer expires
+ * @param timerId A pointer to return the timer id in (can be NULL)
+ * @return Std_ReturnType
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly or the Scheduler
+ *                            does not poll the timers (SCHED_SOFTWARE_TIMERS is STD_OFF)
+ */
+Std_ReturnType Timer_Start(uint32_t timeUS, timerCb_t callBack, uint16_t* timerId)
+{
+    Std_ReturnType error = E_NOT_OK;
+#if SCHED_SOFTWARE_TIMERS == STD_ON
+    uint32_t primask;
+    uint32_t now;
+    uint32_t expiry;
+    uint8_t id;
+    uint8_t prev = TIMER_NO_TIMER;
+    uint8_t curr;
+    if(callBack && (sint32_t)timeUS >= 0)
+    {
+        CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+        id = 0;
+        while(id < TIMER_MAX_NUMBER_OF_TIMERS && Timer_timer[id].callBack)
+        {
+            id++;
+        }
+        if(id < TIMER_MAX_NUMBER_OF_TIMERS)
+        {
+            Sched_GetTimeUS(&now);
+            expiry = now + timeUS;
+            curr = Timer_head;
+            /* Timers with the same expiry keep their start order */
+            while(TIMER_NO_TIMER != curr && (sint32_t)(Timer_timer[curr].expiry - expiry) <= 0)
+            {
+                prev = curr;
+                curr = Timer_timer[curr].next;
+            }
+            Timer_timer[id].expiry = expiry;
+            Timer_timer[id].callBack = callBack;
+            Timer_timer[id].next = curr;
+            if(TIMER_NO_TIMER == prev)
+            {
+                Timer_head = id;
+            }
+            else
+            {
+                Timer_timer[prev].next = id;
+            }
+            if(timerId)
+            {
+                *timerId = TIMER_ID(id, Timer_timer[id].generation);
+            }
+            /* A stretched idle period may end after the timer */
+            Sched_NewDeadline(timeUS);
+            error = E_OK;
+        }
+        CRITICAL_RESTORE_INTERRUPTS(primask);
+    }
+#else
+    /* Nothing would ever expire the timer */
+    (void)timeUS;
+    (void)callBack;
+    (void)timerId;
+#endif
+    return error;
+}
+
+/**
+ * @brief Stops a timer before it expires
+ *
+ * @param timerId The timer id
+ * @return Std_ReturnType
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+Std_ReturnType Timer_Stop(uint16_t timerId)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t primask;
+    uint8_t id = TIMER_ID_SLOT(timerId);
+    if(id < TIMER_MAX_NUMBER_OF_TIMERS)
+    {
+        CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+        if(Timer_timer[id].callBack && TIMER_ID_GENERATION(timerId) == Timer_timer[id].generation)
+        {
+            Timer_Remove(id);
+            Timer_timer[id].callBack = NULL;
+            Timer_timer[id].generation++;
+            error = E_OK;
+        }
+        CRITICAL_RESTORE_INTERRUPTS(primask);
+    }
+    return error;
+}
+
+/**
+ * @brief Calls the callbacks of the expired timers (called by the Scheduler)
+ *
+ */
+void Timer_Poll(void)
+{
+    uint32_t primask;
+    uint32_t now;
+    uint8_t id;
+    timerCb_t callBack;
+    while(TIMER_NO_TIMER != Timer_head)
+    {
+        callBack = NULL;
+        CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+        id = Timer_head;
+        Sched_GetTimeUS(&now);
+        if(TIMER_NO_TIMER != id && TIMER_IS_EXPIRED(Timer_timer[id].expiry, now))
+        {
+            Timer_head = Timer_timer[id].next;
+            callBack = Timer_timer[id].callBack;
+            /* The slot is free again so the callback can start a new timer */
+            Timer_timer[id].callBack = NULL;
+            Timer_timer[id].generation++;
+        }
+        CRITICAL_RESTORE_INTERRUPTS(primask);
+        if(NULL == callBack)
+        {
+            break;
+        }
+        callBack();
+    }
+}
+
+/**
+ * @brief Gets the time until the nearest timer expires
+ *
+ * @param timeUS A pointer to return the time in micro seconds in
+ * @return Std_ReturnType
+ *                 E_OK : if a timer is running
+ *                 E_NOT_OK : if no timer is running
+ */
+Std_ReturnType Timer_GetNextExpiry(uint32_t* timeUS)
+{
+    Std_ReturnType error = E_NOT_OK;
+    uint32_t primask;
+    uint32_t now;
+    if(timeUS)
+    {
+        CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+        if(TIMER_NO_TIMER != Timer_head)
+        {
+            Sched_GetTimeUS(&now);
+            if(TIMER_IS_EXPIRED(Timer_timer[Timer_head].expiry, now))
+            {
+                *timeUS = 0;
+            }
+            else
+            {
+                *timeUS = Timer_timer[Timer_head].expiry - now;
+            }
+            error = E_OK;
+        }
+        CRITICAL_RESTORE_INTERRUPTS(primask);
+    }
+    return error;
+}
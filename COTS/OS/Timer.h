@@ -0,0 +1,69 @@
+/**
+ * @file Timer.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This file is the user interface for the Software Timers
+ *        (one shot timers with a micro second resolution polled by the Scheduler)
+ * @version 0.1
+ * @date 2020-03-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef TIMER_H
+#define TIMER_H
+
+/* An id that never belongs to a timer, an id holds the slot in its low byte and the generation of the slot in its high byte */
+#define TIMER_NO_TIMER                    0xFF
+
+typedef void (*timerCb_t)(void);
+
+/**
+ * @brief The initialization for the Software Timers
+ * 
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+extern Std_ReturnType Timer_Init(void);
+
+/**
+ * @brief Starts a one shot timer
+ * 
+ * @param timeUS The time before the callback is called in micro seconds
+ * @param callBack The function to call when the timer expires
+ * @param timerId A pointer to return the timer id in (can be NULL)
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly or the Scheduler
+ *                            does not poll the timers (SCHED_SOFTWARE_TIMERS is STD_OFF)
+ */
+extern Std_ReturnType Timer_Start(uint32_t timeUS, timerCb_t callBack, uint16_t* timerId);
+
+/**
+ * @brief Stops a timer before it expires, the id of a timer that expired or was stopped
+ *        is refused even when its slot runs another timer
+ * 
+ * @param timerId The timer id
+ * @return Std_ReturnType 
+ *                 E_OK : if the function is executed correctly
+ *                 E_NOT_OK : if the function is not executed correctly
+ */
+extern Std_ReturnType Timer_Stop(uint16_t timerId);
+
+/**
+ * @brief Calls the callbacks of the expired timers (called by the Scheduler)
+ * 
+ */
+extern void Timer_Poll(void);
+
+/**
+ * @brief Gets the time until the nearest timer expires
+ * 
+ * @param timeUS A pointer to return the time in micro seconds in
+ * @return Std_ReturnType 
+ *                 E_OK : if a timer is running
+ *                 E_NOT_OK : if no timer is running
+ */
+extern Std_ReturnType Timer_GetNextExpiry(uint32_t* timeUS);
+
+#endif
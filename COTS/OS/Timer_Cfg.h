@@ -0,0 +1,17 @@
+/**
+ * @file Timer_Cfg.h
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This file contains the configurations for the Software Timers
+ * @version 0.1
+ * @date 2020-03-08
+ * 
+ * @copyright Copyright (c) 2020
+ * 
+ */
+#ifndef TIMER_CFG_H
+#define TIMER_CFG_H
+
+/* The number of timers that can be running at the same time */
+#define TIMER_MAX_NUMBER_OF_TIMERS        8
+
+#endif
@@ -0,0 +1,278 @@
+/**
+ * @file SchedDispatchBench.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This file is a host benchmark of the tick dispatch of the cooperative Scheduler, it
+ *        compares the sorted delta list of Sched.c against the scan of every task on every tick
+ *        that it replaced, for 2 to 254 tasks (the most the uint8_t links of Sched.c can hold)
+ *
+ *        Build : gcc -O2 -o SchedDispatchBench SchedDispatchBench.c
+ *        Usage : SchedDispatchBench [ticks]
+ *
+ *        It prints a table for a mix of 1 ms to 1 s tasks and one for 10 ms to 1 s tasks (1 ms tick),
+ *        every line is "<tasks> <scan ns per tick> <delta list ns per tick> <runs per tick>",
+ *        both dispatchers must run every task on the same ticks or the benchmark fails
+ * @version 0.1
+ * @date 2020-03-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DISPATCH_BENCH_MAX_TASKS         254
+#define DISPATCH_BENCH_NO_TASK           0xFF
+#define DISPATCH_BENCH_DEFAULT_TICKS     100000UL
+#define DISPATCH_BENCH_RUNS              5               /* The best run of those is kept */
+
+#define DISPATCH_BENCH_NUMBER_OF_PERIODS 7
+
+/**
+ * @brief A set of periods in ticks given to the tasks in turn
+ *
+ */
+typedef struct
+{
+    const char* name;
+    unsigned long period[DISPATCH_BENCH_NUMBER_OF_PERIODS];
+} dispatchBenchMix_t;
+
+static const dispatchBenchMix_t DispatchBench_mix[] =
+{
+    {"1 ms to 1 s tasks", {1, 5, 10, 50, 100, 500, 1000}},
+    {"10 ms to 1 s tasks", {10, 20, 50, 100, 200, 500, 1000}}
+};
+#define DISPATCH_BENCH_NUMBER_OF_MIXES   (sizeof(DispatchBench_mix) / sizeof(DispatchBench_mix[0]))
+
+static const unsigned char DispatchBench_tasks[] = {2, 4, 8, 16, 32, 64, 128, 254};
+#define DISPATCH_BENCH_NUMBER_OF_SIZES   (sizeof(DispatchBench_tasks) / sizeof(DispatchBench_tasks[0]))
+
+/**
+ * @brief A task as Sched.c keeps it
+ *
+ */
+typedef struct
+{
+    void (*runnable)(void);
+    unsigned long remainToExec;
+    unsigned long periodTicks;
+    unsigned char next;
+} dispatchBenchTask_t;
+
+static dispatchBenchTask_t DispatchBench_task[DISPATCH_BENCH_MAX_TASKS];
+static unsigned char DispatchBench_numberOfTasks;
+static unsigned char DispatchBench_dueHead;
+static unsigned char DispatchBench_taskItr;
+
+/* The runs of every task, the two dispatchers must end with the same counts */
+static unsigned long DispatchBench_runs[DISPATCH_BENCH_MAX_TASKS];
+
+/**
+ * @brief The runnable of every task, it only counts its run
+ *
+ */
+__attribute__((noinline)) static void DispatchBench_Runnable(void)
+{
+    DispatchBench_runs[DispatchBench_taskItr]++;
+}
+
+/**
+ * @brief Gets the time in nano seconds
+ *
+ * @return unsigned long long The time
+ */
+static unsigned long long DispatchBench_Now(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+}
+
+/**
+ * @brief Sets up the tasks, all of them are due on the first tick
+ *
+ * @param mix The periods of the tasks
+ * @param numberOfTasks The number of tasks
+ */
+static void DispatchBench_Setup(const dispatchBenchMix_t* mix, unsigned char numberOfTasks)
+{
+    unsigned char i;
+    DispatchBench_numberOfTasks = numberOfTasks;
+    for(i=0; i<numberOfTasks; i++)
+    {
+        DispatchBench_task[i].runnable = DispatchBench_Runnable;
+        DispatchBench_task[i].remainToExec = 0;
+        DispatchBench_task[i].periodTicks = mix->period[i % DISPATCH_BENCH_NUMBER_OF_PERIODS];
+        DispatchBench_runs[i] = 0;
+    }
+}
+
+/**
+ * @brief The tick of the scan, every task is touched on every tick
+ *
+ */
+static void DispatchBench_ScanTick(void)
+{
+    for(DispatchBench_taskItr=0; DispatchBench_taskItr<DispatchBench_numberOfTasks; DispatchBench_taskItr++)
+    {
+        if(0 == DispatchBench_task[DispatchBench_taskItr].remainToExec)
+        {
+            DispatchBench_task[DispatchBench_taskItr].remainToExec = DispatchBench_task[DispatchBench_taskItr].periodTicks;
+            DispatchBench_task[DispatchBench_taskItr].runnable();
+        }
+        DispatchBench_task[DispatchBench_taskItr].remainToExec--;
+    }
+}
+
+/**
+ * @brief Sched_InsertTask, the tasks due on the same tick keep the index order
+ *
+ * @param taskIndex The index of the task, its remainToExec holds the ticks from now
+ */
+static void DispatchBench_InsertTask(unsigned char taskIndex)
+{
+    unsigned char prev = DISPATCH_BENCH_NO_TASK;
+    unsigned char curr = DispatchBench_dueHead;
+    unsigned long ticks = DispatchBench_task[taskIndex].remainToExec;
+    while(DISPATCH_BENCH_NO_TASK != curr && (DispatchBench_task[curr].remainToExec < ticks ||
+          (DispatchBench_task[curr].remainToExec == ticks && curr < taskIndex)))
+    {
+        ticks -= DispatchBench_task[curr].remainToExec;
+        prev = curr;
+        curr = DispatchBench_task[curr].next;
+    }
+    DispatchBench_task[taskIndex].remainToExec = ticks;
+    DispatchBench_task[taskIndex].next = curr;
+    if(DISPATCH_BENCH_NO_TASK != curr)
+    {
+        DispatchBench_task[curr].remainToExec -= ticks;
+    }
+    if(DISPATCH_BENCH_NO_TASK == prev)
+    {
+        DispatchBench_dueHead = taskIndex;
+    }
+    else
+    {
+        DispatchBench_task[prev].next = taskIndex;
+    }
+}
+
+/**
+ * @brief Sched_Tick, only the head of the due list and the due tasks are touched
+ *
+ */
+static void DispatchBench_DeltaTick(void)
+{
+    while(DISPATCH_BENCH_NO_TASK != DispatchBench_dueHead && 0 == DispatchBench_task[DispatchBench_dueHead].remainToExec)
+    {
+        DispatchBench_taskItr = DispatchBench_dueHead;
+        DispatchBench_dueHead = DispatchBench_task[DispatchBench_taskItr].next;
+        DispatchBench_task[DispatchBench_taskItr].remainToExec = DispatchBench_task[DispatchBench_taskItr].periodTicks;
+        DispatchBench_task[DispatchBench_taskItr].runnable();
+        DispatchBench_InsertTask(DispatchBench_taskItr);
+    }
+    if(DISPATCH_BENCH_NO_TASK != DispatchBench_dueHead)
+    {
+        DispatchBench_task[DispatchBench_dueHead].remainToExec--;
+    }
+}
+
+/**
+ * @brief Runs a dispatcher over the ticks and keeps the best time of the runs
+ *
+ * @param mix The periods of the tasks
+ * @param numberOfTasks The number of tasks
+ * @param ticks The number of ticks
+ * @param delta 1 for the delta list, 0 for the scan
+ * @param runs An array to return the runs of every task in
+ * @return double The best time per tick in nano seconds
+ */
+static double DispatchBench_Measure(const dispatchBenchMix_t* mix, unsigned char numberOfTasks, unsigned long ticks, unsigned char delta, unsigned long* runs)
+{
+    unsigned long long start;
+    unsigned long long elapsed;
+    unsigned long long best = (unsigned long long)-1;
+    unsigned long tick;
+    unsigned char i;
+    int run;
+    for(run=0; run<DISPATCH_BENCH_RUNS; run++)
+    {
+        DispatchBench_Setup(mix, numberOfTasks);
+        if(delta)
+        {
+            DispatchBench_dueHead = DISPATCH_BENCH_NO_TASK;
+            for(i=0; i<numberOfTasks; i++)
+            {
+                DispatchBench_InsertTask(i);
+            }
+        }
+        start = DispatchBench_Now();
+        for(tick=0; tick<ticks; tick++)
+        {
+            if(delta)
+            {
+                DispatchBench_DeltaTick();
+            }
+            else
+            {
+                DispatchBench_ScanTick();
+            }
+        }
+        elapsed = DispatchBench_Now() - start;
+        if(elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+    for(i=0; i<numberOfTasks; i++)
+    {
+        runs[i] = DispatchBench_runs[i];
+    }
+    return (double)best / (double)ticks;
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned long scanRuns[DISPATCH_BENCH_MAX_TASKS];
+    unsigned long deltaRuns[DISPATCH_BENCH_MAX_TASKS];
+    unsigned long ticks = DISPATCH_BENCH_DEFAULT_TICKS;
+    unsigned long long totalRuns;
+    double scanNS;
+    double deltaNS;
+    unsigned long mix;
+    unsigned long size;
+    unsigned char numberOfTasks;
+    unsigned char i;
+
+    if(argc > 2 || (argc == 2 && 0 == (ticks = strtoul(argv[1], NULL, 10))))
+    {
+        fprintf(stderr, "Usage : %s [ticks]\n", argv[0]);
+        return 1;
+    }
+
+    for(mix=0; mix<DISPATCH_BENCH_NUMBER_OF_MIXES; mix++)
+    {
+        printf("%s over %lu ticks\n", DispatchBench_mix[mix].name, ticks);
+        printf("%-6s %14s %14s %14s\n", "Tasks", "Scan ns/tick", "Delta ns/tick", "Runs/tick");
+        for(size=0; size<DISPATCH_BENCH_NUMBER_OF_SIZES; size++)
+        {
+            numberOfTasks = DispatchBench_tasks[size];
+            scanNS = DispatchBench_Measure(&DispatchBench_mix[mix], numberOfTasks, ticks, 0, scanRuns);
+            deltaNS = DispatchBench_Measure(&DispatchBench_mix[mix], numberOfTasks, ticks, 1, deltaRuns);
+            totalRuns = 0;
+            for(i=0; i<numberOfTasks; i++)
+            {
+                if(scanRuns[i] != deltaRuns[i])
+                {
+                    fprintf(stderr, "Task %u of %u ran %lu times with the scan and %lu times with the delta list\n",
+                            i, numberOfTasks, scanRuns[i], deltaRuns[i]);
+                    return 1;
+                }
+                totalRuns += scanRuns[i];
+            }
+            printf("%-6u %14.2f %14.2f %14.2f\n", numberOfTasks, scanNS, deltaNS, (double)totalRuns / (double)ticks);
+        }
+    }
+    return 0;
+}
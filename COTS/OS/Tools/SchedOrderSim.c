@@ -0,0 +1,194 @@
+/**
+ * @file SchedOrderSim.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This file is a host simulation of the cooperative Scheduler that compares the
+ *        worst case response time of every task between the configuration order and
+ *        the rate monotonic order of the tasks due on the same tick
+ *
+ *        Build : gcc -O2 -o SchedOrderSim SchedOrderSim.c
+ *        Usage : SchedOrderSim <tick time in ms> < tasks.txt
+ *
+ *        Every line of the input holds a task in the configuration order
+ *        "<task name> <periodic time in ms> <worst case execution time in us> [first delay in ticks]"
+ * @version 0.1
+ * @date 2020-03-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SCHED_SIM_MAX_TASKS              64
+#define SCHED_SIM_MAX_NAME               64
+#define SCHED_SIM_MAX_LINE               256
+#define SCHED_SIM_MAX_HYPERPERIOD        1000000UL     /* The longest hyperperiod in ticks */
+
+#define SCHED_SIM_ORDER_INDEX            0
+#define SCHED_SIM_ORDER_RATE_MONOTONIC   1
+
+/**
+ * @brief A task read from the input
+ *
+ */
+typedef struct
+{
+    char name[SCHED_SIM_MAX_NAME];          /* The task name */
+    unsigned long periodTicks;              /* The periodic time in ticks */
+    unsigned long wcetUS;                   /* The worst case execution time in micro seconds */
+    unsigned long delayTicks;               /* The first delay in ticks */
+} schedSimTask_t;
+
+static schedSimTask_t SchedSim_task[SCHED_SIM_MAX_TASKS];
+static unsigned long SchedSim_numberOfTasks;
+
+/**
+ * @brief Gets the greatest common divisor of two numbers
+ *
+ * @param a The first number
+ * @param b The second number
+ * @return unsigned long The greatest common divisor
+ */
+static unsigned long SchedSim_Gcd(unsigned long a, unsigned long b)
+{
+    unsigned long temp;
+    while(b)
+    {
+        temp = a % b;
+        a = b;
+        b = temp;
+    }
+    return a;
+}
+
+/**
+ * @brief Orders the tasks by their periodic time, the configuration order breaks the ties
+ *
+ * @param a The first task index
+ * @param b The second task index
+ * @return int The order
+ */
+static int SchedSim_ComparePeriod(const void* a, const void* b)
+{
+    unsigned long indexA = *(const unsigned long*)a;
+    unsigned long indexB = *(const unsigned long*)b;
+    int order;
+    if(SchedSim_task[indexA].periodTicks != SchedSim_task[indexB].periodTicks)
+    {
+        order = (SchedSim_task[indexA].periodTicks < SchedSim_task[indexB].periodTicks) ? -1 : 1;
+    }
+    else
+    {
+        order = (indexA < indexB) ? -1 : 1;
+    }
+    return order;
+}
+
+/**
+ * @brief Runs the cooperative Scheduler over two hyperperiods, the tasks due on a tick run
+ *        back to back and a tick that is still busy delays the next one
+ *
+ * @param order The dispatch order
+ * @param hyperperiod The hyperperiod in ticks
+ * @param tickUS The tick time in micro seconds
+ * @param response An array to return the worst case response time of every task in
+ */
+static void SchedSim_Run(unsigned char order, unsigned long hyperperiod, unsigned long tickUS, unsigned long* response)
+{
+    unsigned long dispatch[SCHED_SIM_MAX_TASKS];
+    unsigned long long now = 0;
+    unsigned long long release;
+    unsigned long tick;
+    unsigned long i;
+    schedSimTask_t* task;
+    for(i=0; i<SchedSim_numberOfTasks; i++)
+    {
+        dispatch[i] = i;
+        response[i] = 0;
+    }
+    if(SCHED_SIM_ORDER_RATE_MONOTONIC == order)
+    {
+        qsort(dispatch, SchedSim_numberOfTasks, sizeof(dispatch[0]), SchedSim_ComparePeriod);
+    }
+    /* The second hyperperiod catches the load carried over from the first one */
+    for(tick=0; tick<2*hyperperiod; tick++)
+    {
+        release = (unsigned long long)tick * tickUS;
+        if(now < release)
+        {
+            now = release;
+        }
+        for(i=0; i<SchedSim_numberOfTasks; i++)
+        {
+            task = &SchedSim_task[dispatch[i]];
+            if(tick >= task->delayTicks && 0 == (tick - task->delayTicks) % task->periodTicks)
+            {
+                now += task->wcetUS;
+                if(now - release > response[dispatch[i]])
+                {
+                    response[dispatch[i]] = (unsigned long)(now - release);
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    char line[SCHED_SIM_MAX_LINE];
+    unsigned long tickMS;
+    unsigned long periodMS;
+    unsigned long hyperperiod = 1;
+    unsigned long indexResponse[SCHED_SIM_MAX_TASKS];
+    unsigned long rmResponse[SCHED_SIM_MAX_TASKS];
+    unsigned long i;
+    int fields;
+    schedSimTask_t* task;
+
+    if(argc != 2 || 0 == (tickMS = strtoul(argv[1], NULL, 10)))
+    {
+        fprintf(stderr, "Usage : %s <tick time in ms> < tasks.txt\n", argv[0]);
+        return 1;
+    }
+
+    while(SchedSim_numberOfTasks < SCHED_SIM_MAX_TASKS && fgets(line, sizeof(line), stdin))
+    {
+        task = &SchedSim_task[SchedSim_numberOfTasks];
+        task->delayTicks = 0;
+        fields = sscanf(line, "%63s %lu %lu %lu", task->name, &periodMS, &task->wcetUS, &task->delayTicks);
+        /* The event activated tasks are not part of the periodic load */
+        if(fields < 3 || 0 == periodMS)
+        {
+            continue;
+        }
+        task->periodTicks = periodMS / tickMS;
+        if(0 == task->periodTicks)
+        {
+            task->periodTicks = 1;
+        }
+        hyperperiod = hyperperiod / SchedSim_Gcd(hyperperiod, task->periodTicks) * task->periodTicks;
+        if(hyperperiod > SCHED_SIM_MAX_HYPERPERIOD)
+        {
+            fprintf(stderr, "The hyperperiod is longer than %lu ticks\n", SCHED_SIM_MAX_HYPERPERIOD);
+            return 1;
+        }
+        SchedSim_numberOfTasks++;
+    }
+    if(0 == SchedSim_numberOfTasks)
+    {
+        fprintf(stderr, "No periodic tasks were read\n");
+        return 1;
+    }
+
+    SchedSim_Run(SCHED_SIM_ORDER_INDEX, hyperperiod, tickMS * 1000, indexResponse);
+    SchedSim_Run(SCHED_SIM_ORDER_RATE_MONOTONIC, hyperperiod, tickMS * 1000, rmResponse);
+
+    printf("Worst case response time in us over %lu ticks\n", 2 * hyperperiod);
+    printf("%-24s %10s %14s %14s\n", "Task", "Period", "Index order", "Rate monotonic");
+    for(i=0; i<SchedSim_numberOfTasks; i++)
+    {
+        printf("%-24s %10lu %14lu %14lu\n", SchedSim_task[i].name, SchedSim_task[i].periodTicks * tickMS,
+               indexResponse[i], rmResponse[i]);
+    }
+    return 0;
+}
@@ -0,0 +1,280 @@
+/**
+ * @file SchedPhase.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This file is a host tool that picks the first delay of every task
+ *        to spread the load over the ticks and writes the Scheduler configurations
+ *
+ *        Build : gcc -O2 -o SchedPhase SchedPhase.c
+ *        Usage : SchedPhase <tick time in ms> < tasks.txt > Sched_Cfg.c
+ *
+ *        Every line of the input holds a task in the configuration order
+ *        "<task symbol> <periodic time in ms> <worst case execution time in us>"
+ *        a task with a periodic time of 0 is event activated and starts with no delay
+ * @version 0.1
+ * @date 2020-03-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCHED_PHASE_MAX_TASKS            64
+#define SCHED_PHASE_MAX_NAME             64
+#define SCHED_PHASE_MAX_HYPERPERIOD      1000000UL     /* The longest hyperperiod in ticks */
+
+/**
+ * @brief A task read from the input
+ *
+ */
+typedef struct
+{
+    char name[SCHED_PHASE_MAX_NAME];        /* The task symbol */
+    unsigned long periodMS;                 /* The periodic time in milli seconds */
+    unsigned long periodTicks;              /* The periodic time in ticks */
+    unsigned long wcetUS;                   /* The worst case execution time in micro seconds */
+    unsigned long delayTicks;               /* The picked first delay in ticks */
+} schedPhaseTask_t;
+
+static schedPhaseTask_t SchedPhase_task[SCHED_PHASE_MAX_TASKS];
+static unsigned long SchedPhase_numberOfTasks;
+
+/**
+ * @brief Gets the greatest common divisor of two numbers
+ *
+ * @param a The first number
+ * @param b The second number
+ * @return unsigned long The greatest common divisor
+ */
+static unsigned long SchedPhase_Gcd(unsigned long a, unsigned long b)
+{
+    unsigned long temp;
+    while(b)
+    {
+        temp = a % b;
+        a = b;
+        b = temp;
+    }
+    return a;
+}
+
+/**
+ * @brief Gets the peak load of the ticks that a task would run on
+ *
+ * @param load The load of every tick in the hyperperiod in micro seconds
+ * @param hyperperiod The hyperperiod in ticks
+ * @param offset The first tick of the task
+ * @param period The periodic time of the task in ticks
+ * @return unsigned long The peak load in micro seconds
+ */
+static unsigned long SchedPhase_PeakAt(const unsigned long* load, unsigned long hyperperiod, unsigned long offset, unsigned long period)
+{
+    unsigned long peak = 0;
+    unsigned long tick;
+    for(tick=offset; tick<hyperperiod; tick+=period)
+    {
+        if(load[tick] > peak)
+        {
+            peak = load[tick];
+        }
+    }
+    return peak;
+}
+
+/**
+ * @brief Gets the peak load of all the ticks in the hyperperiod
+ *
+ * @param load The load of every tick in the hyperperiod in micro seconds
+ * @param hyperperiod The hyperperiod in ticks
+ * @return unsigned long The peak load in micro seconds
+ */
+static unsigned long SchedPhase_Peak(const unsigned long* load, unsigned long hyperperiod)
+{
+    return SchedPhase_PeakAt(load, hyperperiod, 0, 1);
+}
+
+/**
+ * @brief Adds the load of a task to the ticks it runs on
+ *
+ * @param load The load of every tick in the hyperperiod in micro seconds
+ * @param hyperperiod The hyperperiod in ticks
+ * @param task The task
+ */
+static void SchedPhase_AddLoad(unsigned long* load, unsigned long hyperperiod, const schedPhaseTask_t* task)
+{
+    unsigned long tick;
+    for(tick=task->delayTicks; tick<hyperperiod; tick+=task->periodTicks)
+    {
+        load[tick] += task->wcetUS;
+    }
+}
+
+/**
+ * @brief Orders the tasks by their utilisation, the heaviest first
+ *
+ * @param a The first task index
+ * @param b The second task index
+ * @return int The order
+ */
+static int SchedPhase_CompareLoad(const void* a, const void* b)
+{
+    const schedPhaseTask_t* taskA = &SchedPhase_task[*(const unsigned long*)a];
+    const schedPhaseTask_t* taskB = &SchedPhase_task[*(const unsigned long*)b];
+    /* wcetA / periodA against wcetB / periodB without the division */
+    unsigned long long loadA = (unsigned long long)taskA->wcetUS * taskB->periodTicks;
+    unsigned long long loadB = (unsigned long long)taskB->wcetUS * taskA->periodTicks;
+    int order = 0;
+    if(loadA > loadB)
+    {
+        order = -1;
+    }
+    else if(loadA < loadB)
+    {
+        order = 1;
+    }
+    else
+    {
+        order = (*(const unsigned long*)a < *(const unsigned long*)b) ? -1 : 1;
+    }
+    return order;
+}
+
+/**
+ * @brief Writes the Scheduler configurations with the picked delays
+ *
+ */
+static void SchedPhase_WriteCfg(void)
+{
+    unsigned long i;
+    printf("/**\n");
+    printf(" * @file Sched_Cfg.c\n");
+    printf(" * @author Mark Attia (markjosephattia@gmail.com)\n");
+    printf(" * @brief This file contains the configurations implementation for the Scheduler\n");
+    printf(" *        (the first delays are generated by SchedPhase)\n");
+    printf(" * @version 0.1\n");
+    printf(" * @date 2020-03-08\n");
+    printf(" * \n");
+    printf(" * @copyright Copyright (c) 2020\n");
+    printf(" * \n");
+    printf(" */\n");
+    printf("\n");
+    printf("#include \"Std_Types.h\"\n");
+    printf("#include \"Sched_Cfg.h\"\n");
+    printf("#include \"Sched.h\"\n");
+    printf("\n");
+    for(i=0; i<SchedPhase_numberOfTasks; i++)
+    {
+        printf("extern const task_t %s;\n", SchedPhase_task[i].name);
+    }
+    printf("\n");
+    printf("const sysTaskInfo_t Sched_sysTaskInfo[SCHED_NUMBER_OF_TASKS] = \n");
+    printf("{\n");
+    for(i=0; i<SchedPhase_numberOfTasks; i++)
+    {
+        printf("    {&%s, %lu, %lu}%s\n", SchedPhase_task[i].name, SchedPhase_task[i].delayTicks, i,
+               (i + 1 < SchedPhase_numberOfTasks) ? "," : "");
+    }
+    printf("};\n");
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned long tickMS;
+    unsigned long hyperperiod = 1;
+    unsigned long order[SCHED_PHASE_MAX_TASKS];
+    unsigned long* load;
+    unsigned long alignedPeak;
+    unsigned long bestOffset;
+    unsigned long bestPeak;
+    unsigned long peak;
+    unsigned long offset;
+    unsigned long i;
+    unsigned long periodic = 0;
+    double utilisation = 0;
+    schedPhaseTask_t* task;
+
+    if(argc != 2 || 0 == (tickMS = strtoul(argv[1], NULL, 10)))
+    {
+        fprintf(stderr, "Usage : %s <tick time in ms> < tasks.txt > Sched_Cfg.c\n", argv[0]);
+        return 1;
+    }
+
+    while(SchedPhase_numberOfTasks < SCHED_PHASE_MAX_TASKS)
+    {
+        task = &SchedPhase_task[SchedPhase_numberOfTasks];
+        if(3 != scanf("%63s %lu %lu", task->name, &task->periodMS, &task->wcetUS))
+        {
+            break;
+        }
+        task->periodTicks = task->periodMS / tickMS;
+        if(0 == task->periodTicks && 0 != task->periodMS)
+        {
+            /* The Scheduler runs the tasks faster than the tick every tick */
+            task->periodTicks = 1;
+        }
+        task->delayTicks = 0;
+        if(task->periodTicks)
+        {
+            hyperperiod = hyperperiod / SchedPhase_Gcd(hyperperiod, task->periodTicks) * task->periodTicks;
+            if(hyperperiod > SCHED_PHASE_MAX_HYPERPERIOD)
+            {
+                fprintf(stderr, "The hyperperiod is longer than %lu ticks\n", SCHED_PHASE_MAX_HYPERPERIOD);
+                return 1;
+            }
+            utilisation += (double)task->wcetUS / (task->periodTicks * tickMS * 1000.0);
+            order[periodic] = SchedPhase_numberOfTasks;
+            periodic++;
+        }
+        SchedPhase_numberOfTasks++;
+    }
+    if(0 == SchedPhase_numberOfTasks)
+    {
+        fprintf(stderr, "No tasks were read\n");
+        return 1;
+    }
+
+    load = calloc(hyperperiod, sizeof(unsigned long));
+    if(NULL == load)
+    {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    /* The peak with every task starting on the first tick */
+    for(i=0; i<periodic; i++)
+    {
+        SchedPhase_AddLoad(load, hyperperiod, &SchedPhase_task[order[i]]);
+    }
+    alignedPeak = SchedPhase_Peak(load, hyperperiod);
+    memset(load, 0, hyperperiod * sizeof(unsigned long));
+
+    /* Place the heaviest tasks first, each one on the offset that keeps the peak lowest */
+    qsort(order, periodic, sizeof(order[0]), SchedPhase_CompareLoad);
+    for(i=0; i<periodic; i++)
+    {
+        task = &SchedPhase_task[order[i]];
+        bestOffset = 0;
+        bestPeak = (unsigned long)-1;
+        for(offset=0; offset<task->periodTicks; offset++)
+        {
+            peak = SchedPhase_PeakAt(load, hyperperiod, offset, task->periodTicks);
+            if(peak < bestPeak)
+            {
+                bestPeak = peak;
+                bestOffset = offset;
+            }
+        }
+        task->delayTicks = bestOffset;
+        SchedPhase_AddLoad(load, hyperperiod, task);
+    }
+
+    fprintf(stderr, "Hyperperiod : %lu ticks (%lu ms)\n", hyperperiod, hyperperiod * tickMS);
+    fprintf(stderr, "Utilisation : %.1f %%\n", utilisation * 100.0);
+    fprintf(stderr, "Peak tick load : %lu us aligned, %lu us with offsets (tick is %lu us)\n",
+            alignedPeak, SchedPhase_Peak(load, hyperperiod), tickMS * 1000);
+    free(load);
+
+    SchedPhase_WriteCfg();
+    return 0;
+}
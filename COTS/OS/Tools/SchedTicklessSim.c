@@ -0,0 +1,572 @@
+/**
+ * @file SchedTicklessSim.c
+ * @author Mark Attia (markjosephattia@gmail.com)
+ * @brief This file is a host simulation of the tickless idle of the cooperative Scheduler,
+ *        it builds the real Sched.c and Timer.c with their own configuration and runs them
+ *        against a simulated 24 bit SysTick and core while random interrupts start timers,
+ *        resume and activate tasks
+ *
+ *        Build : gcc -O2 -I../../LIB/Header -I../../MCAL/Header -o SchedTicklessSim SchedTicklessSim.c
+ *        Usage : SchedTicklessSim <simulated seconds> [seed]
+ *
+ *        Sched.c and Timer.c are included below after the simulation configuration so they use
+ *        it instead of Sched_Cfg.h, the exit code is 1 if a deadline was missed by more than its bound
+ * @version 0.1
+ * @date 2020-03-08
+ *
+ * @copyright Copyright (c) 2020
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <setjmp.h>
+#include "Std_Types.h"
+
+/* The simulation configuration of the Scheduler, a 1 MHz SysTick clock makes one count a micro second */
+#define SCHED_CFG_H
+#define SCHED_NUMBER_OF_TASKS             5
+#define SCHED_MAX_NUMBER_OF_TASKS         5
+#define SCHED_TICK_TIME_MS                1
+#define SCHED_AHB_CLK                     1000000
+#define SCHED_CPU_CLK                     8000000
+#define SCHED_MODE                        SCHED_MODE_COOPERATIVE
+#define SCHED_PRIORITY_ORDER              SCHED_PRIORITY_RATE_MONOTONIC
+#define SCHED_TASK_STACK_SIZE             512
+#define SCHED_TASK_STATS                  STD_ON
+#define SCHED_CATCHUP_POLICY              SCHED_CATCHUP_SKIP
+#define SCHED_CATCHUP_DROP_PERIOD_MS      100
+#define SCHED_TICKLESS_IDLE               STD_ON
+#define SCHED_SOFTWARE_TIMERS             STD_ON
+
+/* The core and the critical sections are given by this file */
+#define SCHED_HOST_SIM
+#define CRITICAL_TRACE
+
+#include "../Sched.c"
+#include "../Timer.c"
+
+#define TICKLESS_SIM_TICK_COUNTS         SCHED_TICK_COUNTS
+#define TICKLESS_SIM_TICK_US             SCHED_TICK_US
+#define TICKLESS_SIM_GUARD_COUNTS        SCHED_IDLE_GUARD_COUNTS
+
+#define TICKLESS_SIM_STEP_COUNTS         12UL          /* The longest code run before the core masks the interrupts */
+#define TICKLESS_SIM_LOOP_COUNTS         48UL          /* The longest pass of the main loop, three masked sections and the register accesses */
+#define TICKLESS_SIM_EVENT_COUNTS        30000UL       /* The longest time between two interrupts */
+#define TICKLESS_SIM_TIMER_US            40000UL       /* The longest timer */
+#define TICKLESS_SIM_MAX_SECONDS         4000UL        /* The micro second time base wraps after 4294 seconds */
+
+#define TICKLESS_SIM_EVENT_TIMER         0
+#define TICKLESS_SIM_EVENT_RESUME        1
+#define TICKLESS_SIM_EVENT_ACTIVATE      2
+
+/* The configured tasks, the periodic ones set the longest stretch */
+#define TICKLESS_SIM_PERIODIC_TASKS      3
+#define TICKLESS_SIM_RESUMED_TASK        3
+#define TICKLESS_SIM_ACTIVATED_TASK      4
+
+/**
+ * @brief The simulated SysTick, the counter counts down from the reload value to 1 and
+ *        takes the reload value again with the interrupt
+ *
+ */
+typedef struct
+{
+    unsigned long load;
+    unsigned long val;
+    unsigned char enabled;
+    unsigned char pending;
+    unsigned char interrupt;
+    systickCb_t callBack;
+} ticklessSimSysTick_t;
+
+/**
+ * @brief The results of a simulation
+ *
+ */
+typedef struct
+{
+    unsigned long long wakeups;             /* The SysTick interrupts */
+    unsigned long long cuts;                /* The stretched periods cut by a new deadline */
+    unsigned long long lostCounts;          /* The counts the time base is behind the real time */
+    unsigned long earlyRuns;                /* The periodic task runs before their tick */
+    unsigned long taskLateUS;               /* The longest time a periodic task ran after its tick */
+    unsigned long resumeLateUS;             /* The longest time a resumed task waited for its pass */
+    unsigned long timerLateUS;              /* The longest time a timer expired late */
+} ticklessSimResult_t;
+
+static ticklessSimSysTick_t TicklessSim_sysTick;
+static unsigned char TicklessSim_started;           /* Set by the first SysTick_Start, the real time starts there */
+static unsigned long long TicklessSim_clock;        /* The real time in counts */
+static unsigned long long TicklessSim_readClock;    /* The real time of the last counter read */
+static unsigned long long TicklessSim_endClock;     /* The real time to leave Sched_Start at */
+static unsigned long long TicklessSim_nextEvent;    /* The real time of the next random interrupt */
+static jmp_buf TicklessSim_end;
+
+/* The core, the interrupts are taken when none of these is set */
+static unsigned char TicklessSim_masked;            /* Set between Sched_HostDisableInterrupts and Sched_HostEnableInterrupts */
+static unsigned long TicklessSim_nesting;           /* The open critical sections */
+static unsigned char TicklessSim_inInterrupt;
+
+/* The expected times of the tasks and timers */
+static const unsigned long TicklessSim_period[TICKLESS_SIM_PERIODIC_TASKS] = {20, 150, 1000};
+static unsigned long TicklessSim_due[TICKLESS_SIM_PERIODIC_TASKS];
+static unsigned char TicklessSim_suspended;
+static unsigned char TicklessSim_resumed;
+static uint32_t TicklessSim_resumeUS;
+static uint32_t TicklessSim_expiry[TIMER_MAX_NUMBER_OF_TIMERS];
+static unsigned char TicklessSim_timerUsed[TIMER_MAX_NUMBER_OF_TIMERS];
+
+static ticklessSimResult_t TicklessSim_result;
+
+/**
+ * @brief Moves the real time by one count
+ *
+ */
+static void TicklessSim_Count(void)
+{
+    TicklessSim_clock++;
+    if(0 == TicklessSim_sysTick.enabled)
+    {
+        /* The time base does not see the counts of a held counter */
+        TicklessSim_result.lostCounts++;
+    }
+    else if(0 == TicklessSim_sysTick.val)
+    {
+        /* A cleared counter takes the reload value on its first clock, that clock is not counted by the time base */
+        TicklessSim_sysTick.val = TicklessSim_sysTick.load;
+        TicklessSim_result.lostCounts++;
+    }
+    else if(1 == TicklessSim_sysTick.val)
+    {
+        TicklessSim_sysTick.val = TicklessSim_sysTick.load;
+        TicklessSim_sysTick.pending = 1;
+    }
+    else
+    {
+        TicklessSim_sysTick.val--;
+    }
+}
+
+static void TicklessSim_Event(void);
+
+/**
+ * @brief Runs the pending interrupts if the core takes them
+ *
+ */
+static void TicklessSim_Interrupts(void)
+{
+    if(0 == TicklessSim_masked && 0 == TicklessSim_nesting && 0 == TicklessSim_inInterrupt)
+    {
+        TicklessSim_inInterrupt = 1;
+        if(TicklessSim_sysTick.pending && TicklessSim_sysTick.interrupt)
+        {
+            TicklessSim_sysTick.pending = 0;
+            TicklessSim_result.wakeups++;
+            TicklessSim_sysTick.callBack();
+        }
+        if(TicklessSim_clock >= TicklessSim_nextEvent)
+        {
+            TicklessSim_Event();
+        }
+        TicklessSim_inInterrupt = 0;
+    }
+}
+
+/**
+ * @brief Lets some time pass, the interrupts run if the core takes them
+ *
+ * @param counts The time in counts
+ */
+static void TicklessSim_Run(unsigned long counts)
+{
+    if(TicklessSim_started)
+    {
+        while(counts > 0)
+        {
+            TicklessSim_Count();
+            TicklessSim_Interrupts();
+            counts--;
+        }
+    }
+}
+
+/**
+ * @brief Records a lateness if it is the longest one
+ *
+ * @param longest The longest lateness so far
+ * @param lateUS The lateness
+ */
+static void TicklessSim_Late(unsigned long* longest, uint32_t lateUS)
+{
+    if(lateUS > *longest)
+    {
+        *longest = lateUS;
+    }
+}
+
+/**
+ * @brief The ticks handled by the scheduler passes so far
+ *
+ * @return unsigned long The ticks
+ */
+static unsigned long TicklessSim_PassTick(void)
+{
+    uint32_t primask;
+    unsigned long ticks;
+    /* A tick is pending or slept through until the pass that takes it */
+    CRITICAL_SAVE_AND_DISABLE_INTERRUPTS(primask);
+    ticks = Sched_tickCount - Sched_pendingTicks - Sched_idleTicks;
+    CRITICAL_RESTORE_INTERRUPTS(primask);
+    return ticks;
+}
+
+/**
+ * @brief The runnable of a periodic task, checks that it runs on its tick
+ *
+ * @param task The index of the periodic task
+ */
+static void TicklessSim_Periodic(unsigned long task)
+{
+    unsigned long passTick = TicklessSim_PassTick();
+    uint32_t nowUS;
+    Sched_GetTimeUS(&nowUS);
+    if(TicklessSim_due[task] > passTick)
+    {
+        TicklessSim_result.earlyRuns++;
+    }
+    else
+    {
+        TicklessSim_Late(&TicklessSim_result.taskLateUS, nowUS - (uint32_t)(TicklessSim_due[task] * TICKLESS_SIM_TICK_US));
+    }
+    /* The skip catch up policy counts the next period from the pass */
+    TicklessSim_due[task] = passTick + TicklessSim_period[task];
+}
+
+static void TicklessSim_Task0(void)
+{
+    TicklessSim_Periodic(0);
+}
+
+static void TicklessSim_Task1(void)
+{
+    TicklessSim_Periodic(1);
+}
+
+static void TicklessSim_Task2(void)
+{
+    TicklessSim_Periodic(2);
+}
+
+/**
+ * @brief The runnable of the task resumed by the interrupts, it suspends itself on every run
+ *
+ */
+static void TicklessSim_Resumed(void)
+{
+    uint32_t nowUS;
+    if(TicklessSim_resumed)
+    {
+        Sched_GetTimeUS(&nowUS);
+        TicklessSim_Late(&TicklessSim_result.resumeLateUS, nowUS - TicklessSim_resumeUS);
+        TicklessSim_resumed = 0;
+    }
+    Sched_SuspendTask();
+    TicklessSim_suspended = 1;
+}
+
+/**
+ * @brief The runnable of the task activated by the interrupts
+ *
+ */
+static void TicklessSim_Activated(void)
+{
+}
+
+static const task_t TicklessSim_task[SCHED_NUMBER_OF_TASKS] =
+{
+    {TicklessSim_Task0, 20},
+    {TicklessSim_Task1, 150},
+    {TicklessSim_Task2, 1000},
+    {TicklessSim_Resumed, 5000},
+    {TicklessSim_Activated, 0}
+};
+
+const sysTaskInfo_t Sched_sysTaskInfo[SCHED_NUMBER_OF_TASKS] =
+{
+    {&TicklessSim_task[0], 0, 0},
+    {&TicklessSim_task[1], 0, 0},
+    {&TicklessSim_task[2], 0, 0},
+    {&TicklessSim_task[3], 0, 0},
+    {&TicklessSim_task[4], 0, 0}
+};
+
+/**
+ * @brief Checks the lateness of an expired timer
+ *
+ * @param timer The slot of the simulation timer
+ */
+static void TicklessSim_TimerExpired(unsigned long timer)
+{
+    uint32_t nowUS;
+    Sched_GetTimeUS(&nowUS);
+    TicklessSim_Late(&TicklessSim_result.timerLateUS, nowUS - TicklessSim_expiry[timer]);
+    TicklessSim_timerUsed[timer] = 0;
+}
+
+/* A timer callback has no parameter so every simulation timer has its own */
+#define TICKLESS_SIM_TIMER_CALLBACK(timer)   static void TicklessSim_Timer##timer(void) { TicklessSim_TimerExpired(timer); }
+TICKLESS_SIM_TIMER_CALLBACK(0)
+TICKLESS_SIM_TIMER_CALLBACK(1)
+TICKLESS_SIM_TIMER_CALLBACK(2)
+TICKLESS_SIM_TIMER_CALLBACK(3)
+TICKLESS_SIM_TIMER_CALLBACK(4)
+TICKLESS_SIM_TIMER_CALLBACK(5)
+TICKLESS_SIM_TIMER_CALLBACK(6)
+TICKLESS_SIM_TIMER_CALLBACK(7)
+
+static const timerCb_t TicklessSim_timerCallBack[TIMER_MAX_NUMBER_OF_TIMERS] =
+{
+    TicklessSim_Timer0, TicklessSim_Timer1, TicklessSim_Timer2, TicklessSim_Timer3,
+    TicklessSim_Timer4, TicklessSim_Timer5, TicklessSim_Timer6, TicklessSim_Timer7
+};
+
+/**
+ * @brief A random interrupt that starts a timer, resumes a task or activates a task
+ *
+ */
+static void TicklessSim_Event(void)
+{
+    uint32_t timeUS;
+    uint32_t nowUS;
+    unsigned long i;
+    switch(rand() % 3)
+    {
+        case TICKLESS_SIM_EVENT_TIMER:
+            for(i=0; i<TIMER_MAX_NUMBER_OF_TIMERS && TicklessSim_timerUsed[i]; i++)
+            {
+            }
+            if(i < TIMER_MAX_NUMBER_OF_TIMERS)
+            {
+                timeUS = (uint32_t)rand() % TICKLESS_SIM_TIMER_US;
+                Sched_GetTimeUS(&nowUS);
+                TicklessSim_expiry[i] = nowUS + timeUS;
+                if(E_OK == Timer_Start(timeUS, TicklessSim_timerCallBack[i], NULL))
+                {
+                    TicklessSim_timerUsed[i] = 1;
+                }
+            }
+            break;
+        case TICKLESS_SIM_EVENT_RESUME:
+            if(TicklessSim_suspended)
+            {
+                Sched_GetTimeUS(&TicklessSim_resumeUS);
+                if(E_OK == Sched_ResumeTask(TICKLESS_SIM_RESUMED_TASK))
+                {
+                    TicklessSim_suspended = 0;
+                    TicklessSim_resumed = 1;
+                }
+            }
+            break;
+        default:
+            Sched_ActivateTask(TICKLESS_SIM_ACTIVATED_TASK);
+            break;
+    }
+    TicklessSim_nextEvent = TicklessSim_clock + 1 + ((unsigned long)rand() % TICKLESS_SIM_EVENT_COUNTS);
+}
+
+/* The core for Sched.c */
+
+void Sched_HostWaitForInterrupt(void)
+{
+    /* A pending interrupt wakes the core up even while they are masked */
+    while(0 == (TicklessSim_sysTick.pending && TicklessSim_sysTick.interrupt) && TicklessSim_clock < TicklessSim_nextEvent)
+    {
+        TicklessSim_Count();
+    }
+}
+
+void Sched_HostDisableInterrupts(void)
+{
+    /* Only the main loop masks the interrupts this way, so the simulation can end here */
+    if(TicklessSim_clock >= TicklessSim_endClock)
+    {
+        longjmp(TicklessSim_end, 1);
+    }
+    TicklessSim_Run(1 + ((unsigned long)rand() % TICKLESS_SIM_STEP_COUNTS));
+    TicklessSim_masked = 1;
+}
+
+void Sched_HostEnableInterrupts(void)
+{
+    TicklessSim_masked = 0;
+    TicklessSim_Interrupts();
+}
+
+/* The critical sections of Critical.h */
+
+void Critical_TraceEnter(void)
+{
+    TicklessSim_nesting++;
+}
+
+void Critical_TraceExit(void)
+{
+    TicklessSim_nesting--;
+    TicklessSim_Interrupts();
+}
+
+/* The SysTick driver, every register access takes a count */
+
+Std_ReturnType SysTick_InterruptEnable(void)
+{
+    TicklessSim_sysTick.interrupt = 1;
+    return E_OK;
+}
+
+Std_ReturnType SysTick_InterruptDisable(void)
+{
+    TicklessSim_sysTick.interrupt = 0;
+    return E_OK;
+}
+
+Std_ReturnType SysTick_Start(void)
+{
+    TicklessSim_Run(1);
+    TicklessSim_sysTick.enabled = 1;
+    TicklessSim_started = 1;
+    return E_OK;
+}
+
+Std_ReturnType SysTick_Stop(void)
+{
+    TicklessSim_Run(1);
+    TicklessSim_sysTick.enabled = 0;
+    return E_OK;
+}
+
+Std_ReturnType SysTick_GetValue(uint32_t* val)
+{
+    TicklessSim_Run(1);
+    *val = TicklessSim_sysTick.val;
+    TicklessSim_readClock = TicklessSim_clock;
+    return E_OK;
+}
+
+Std_ReturnType SysTick_SetReloadValue(uint32_t val)
+{
+    TicklessSim_Run(1);
+    TicklessSim_sysTick.load = val & 0x00FFFFFFUL;
+    return E_OK;
+}
+
+Std_ReturnType SysTick_SetCallBack(systickCb_t func)
+{
+    TicklessSim_sysTick.callBack = func;
+    return E_OK;
+}
+
+Std_ReturnType SysTick_ClearValue(void)
+{
+    TicklessSim_Run(1);
+    if(TicklessSim_started)
+    {
+        /* Only Sched_CutIdle clears a running counter */
+        TicklessSim_result.cuts++;
+    }
+    TicklessSim_sysTick.val = 0;
+    return E_OK;
+}
+
+Std_ReturnType SysTick_SetTimeUS(uint32_t AHB_Clock, uint32_t timeUS)
+{
+    TicklessSim_sysTick.load = (AHB_Clock / 1000000UL) * timeUS;
+    return E_OK;
+}
+
+Std_ReturnType SysTick_IsPending(uint8_t* state)
+{
+    TicklessSim_Run(1);
+    *state = TicklessSim_sysTick.pending ? SYSTICK_PENDING : SYSTICK_NOT_PENDING;
+    return E_OK;
+}
+
+/* The DWT cycle counter follows the real time */
+
+Std_ReturnType Dwt_Init(void)
+{
+    return E_OK;
+}
+
+Std_ReturnType Dwt_GetCycles(uint32_t* cycles)
+{
+    *cycles = (uint32_t)(TicklessSim_clock * (SCHED_CPU_CLK / SCHED_AHB_CLK));
+    return E_OK;
+}
+
+/**
+ * @brief Runs Sched_Start until the simulated time ends
+ *
+ */
+static void TicklessSim_Start(void)
+{
+    if(0 == setjmp(TicklessSim_end))
+    {
+        Sched_Start();
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned long seconds;
+    unsigned long seed = 1;
+    unsigned long long realUS;
+    uint32_t baseUS;
+    unsigned long i;
+    unsigned long timerBoundUS = 2 * TICKLESS_SIM_LOOP_COUNTS;
+    unsigned long resumeBoundUS = TICKLESS_SIM_TICK_US + TICKLESS_SIM_GUARD_COUNTS + (2 * TICKLESS_SIM_LOOP_COUNTS);
+    int failed = 0;
+
+    if(argc < 2 || argc > 3 || 0 == (seconds = strtoul(argv[1], NULL, 10)) || seconds > TICKLESS_SIM_MAX_SECONDS)
+    {
+        fprintf(stderr, "Usage : %s <simulated seconds up to %lu> [seed]\n", argv[0], TICKLESS_SIM_MAX_SECONDS);
+        return 1;
+    }
+    if(argc > 2)
+    {
+        seed = strtoul(argv[2], NULL, 10);
+    }
+    srand((unsigned int)seed);
+
+    /* Every task is first due on the tick after its delay */
+    for(i=0; i<TICKLESS_SIM_PERIODIC_TASKS; i++)
+    {
+        TicklessSim_due[i] = 1;
+    }
+    TicklessSim_endClock = (unsigned long long)seconds * 1000000UL;
+    TicklessSim_nextEvent = (unsigned long)rand() % TICKLESS_SIM_EVENT_COUNTS;
+    Sched_Init();
+    TicklessSim_Start();
+    Sched_GetTimeUS(&baseUS);
+    /* The time base is from the last counter read, reading it took some counts */
+    realUS = TicklessSim_readClock;
+
+    printf("Simulated %lu s with a %lu us tick (seed %lu)\n", seconds, (unsigned long)TICKLESS_SIM_TICK_US, seed);
+    printf("%-36s %12llu\n", "SysTick wakeups", TicklessSim_result.wakeups);
+    printf("%-36s %12lu\n", "Wakeups with a periodic tick", (unsigned long)Sched_tickCount);
+    printf("%-36s %12llu\n", "Stretched periods cut", TicklessSim_result.cuts);
+    printf("%-36s %12llu\n", "Time base behind the real time (us)", realUS - baseUS);
+    printf("%-36s %12llu\n", "Counts lost by the cuts", TicklessSim_result.lostCounts);
+    printf("%-36s %12lu\n", "Periodic task runs before their tick", TicklessSim_result.earlyRuns);
+    printf("%-36s %12lu (bound %lu)\n", "Longest periodic task lateness (us)", TicklessSim_result.taskLateUS, (unsigned long)TICKLESS_SIM_TICK_US);
+    printf("%-36s %12lu (bound %lu)\n", "Longest resumed task wait (us)", TicklessSim_result.resumeLateUS, resumeBoundUS);
+    printf("%-36s %12lu (bound %lu)\n", "Longest timer lateness (us)", TicklessSim_result.timerLateUS, timerBoundUS);
+
+    if(TicklessSim_result.earlyRuns > 0 || TicklessSim_result.taskLateUS >= TICKLESS_SIM_TICK_US ||
+       TicklessSim_result.resumeLateUS > resumeBoundUS || TicklessSim_result.timerLateUS > timerBoundUS ||
+       realUS - baseUS != TicklessSim_result.lostCounts)
+    {
+        printf("FAIL\n");
+        failed = 1;
+    }
+    return failed;
+}